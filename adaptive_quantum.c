@@ -0,0 +1,67 @@
+#include "adaptive_quantum.h"
+
+/*
+    * Initializes the adaptive quantum controller.
+    *
+    * @param controller The adaptive quantum controller
+    * @param target_percent The largest percentage of a slice that may be spent switching
+    * @param time_unit_ms The real duration of one unit of simulation time in milliseconds
+    * @param base_quantum The quantum used at the reference queue depth
+    * @param max_quantum The longest quantum that may be chosen, 0 for the default
+    */
+void init_adaptive_quantum(adaptive_quantum_t *controller, double target_percent, double time_unit_ms, int base_quantum, int max_quantum) {
+    controller->target_overhead = target_percent / 100;
+    controller->time_unit_ns = time_unit_ms * 1e6;
+    controller->switch_cost_ns = 0;
+    controller->base_quantum = base_quantum;
+    controller->max_quantum = max_quantum > 0 ? max_quantum : base_quantum * DEFAULT_MAX_QUANTUM_FACTOR;
+}
+
+/*
+    * Records the real cost of one context switch (suspend and continue).
+    *
+    * @param controller The adaptive quantum controller
+    * @param cost_ns The time the switch took in nanoseconds
+    */
+void record_switch_cost(adaptive_quantum_t *controller, double cost_ns) {
+    // The first measurement seeds the average
+    if (controller->switch_cost_ns == 0) {
+        controller->switch_cost_ns = cost_ns;
+    } else {
+        controller->switch_cost_ns += SWITCH_COST_WEIGHT * (cost_ns - controller->switch_cost_ns);
+    }
+}
+
+/*
+    * Chooses the quantum for the next slice.
+    * The slice shrinks as the ready queue deepens, so a round over the waiting processes keeps roughly
+    * the length of REFERENCE_QUEUE_DEPTH base quanta. It is never shorter than the quantum that keeps
+    * the switch overhead under the target, which may lengthen it past the base quantum. With nobody
+    * waiting, the longest quantum is used, since every slice still pays a resume handshake.
+    *
+    * @param controller The adaptive quantum controller
+    * @param ready_queue_depth The number of processes in the ready queue
+    * @return The quantum for the next slice
+    */
+int next_quantum(const adaptive_quantum_t *controller, int ready_queue_depth) {
+    if (ready_queue_depth == 0) {
+        return controller->max_quantum;
+    }
+
+    // Share the reference round between the waiting processes
+    double quantum = ceil((double) controller->base_quantum * REFERENCE_QUEUE_DEPTH / ready_queue_depth);
+
+    // overhead = switch cost / (quantum * time unit), solved for the shortest quantum within the target
+    double budget = controller->target_overhead * controller->time_unit_ns;
+    double overhead_quantum = budget > 0 ? ceil(controller->switch_cost_ns / budget) : controller->max_quantum;
+    if (quantum < overhead_quantum) {
+        quantum = overhead_quantum;
+    }
+
+    if (quantum < 1) {
+        return 1;
+    } else if (quantum > controller->max_quantum) {
+        return controller->max_quantum;
+    }
+    return (int) quantum;
+}
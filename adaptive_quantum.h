@@ -0,0 +1,33 @@
+#ifndef ADAPTIVE_QUANTUM_H
+#define ADAPTIVE_QUANTUM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Weight of the newest measurement in the switch cost average
+#define SWITCH_COST_WEIGHT 0.2
+// Ready queue depth at which the base quantum is used, the slice scales inversely with the depth
+#define REFERENCE_QUEUE_DEPTH 4
+// Longest slice as a multiple of the base quantum when no maximum is configured
+#define DEFAULT_MAX_QUANTUM_FACTOR 4
+
+// Adaptive quantum controller for round robin
+typedef struct {
+    // Largest share of a slice that may be spent switching, between 0 and 1
+    double target_overhead;
+    // Real duration of one unit of simulation time in nanoseconds
+    double time_unit_ns;
+    // Moving average of the measured switch cost in nanoseconds
+    double switch_cost_ns;
+    // Slice used at the reference queue depth
+    int base_quantum;
+    int max_quantum;
+} adaptive_quantum_t;
+
+// Adaptive quantum functions
+void init_adaptive_quantum(adaptive_quantum_t *controller, double target_percent, double time_unit_ms, int base_quantum, int max_quantum);
+void record_switch_cost(adaptive_quantum_t *controller, double cost_ns);
+int next_quantum(const adaptive_quantum_t *controller, int ready_queue_depth);
+
+#endif // ADAPTIVE_QUANTUM_H
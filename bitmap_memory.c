@@ -0,0 +1,469 @@
+#include "bitmap_memory.h"
+
+#define WORD_BITS 64
+#define ALL_ONES (~(uint64_t) 0)
+
+// A maximal run of free units
+typedef struct {
+    unsigned int start;
+    unsigned int length;
+} free_run_t;
+
+/*
+    * Find the first bit at or after pos that is set (or clear) in the given bit array.
+    * Whole words are tested at once, so runs of uninteresting bits are skipped 64 at a time.
+    *
+    * @param bits The bit array
+    * @param limit The number of valid bits in the array
+    * @param pos The position to start searching from
+    * @param want_set True to look for a set bit, false to look for a clear bit
+    * @return The index of the bit found, or limit if there is none
+    */
+static unsigned int find_next_bit(const uint64_t *bits, unsigned int limit, unsigned int pos, bool want_set) {
+    while (pos < limit) {
+        uint64_t word = want_set ? bits[pos / WORD_BITS] : ~bits[pos / WORD_BITS];
+        word &= ALL_ONES << (pos % WORD_BITS);
+        unsigned int base = pos - pos % WORD_BITS;
+        if (word) {
+            unsigned int found = base + __builtin_ctzll(word);
+            return found < limit ? found : limit;
+        }
+        pos = base + WORD_BITS;
+    }
+    return limit;
+}
+
+/*
+    * Refresh the summary bits of a word after it has been modified.
+    *
+    * @param memory The bitmap memory
+    * @param index The index of the modified word
+    */
+static void update_summary(bitmap_mem_t *memory, unsigned int index) {
+    uint64_t mask = (uint64_t) 1 << (index % WORD_BITS);
+    unsigned int slot = index / WORD_BITS;
+
+    if (memory->words[index] == ALL_ONES) {
+        memory->full[slot] |= mask;
+    } else {
+        memory->full[slot] &= ~mask;
+    }
+
+    if (memory->words[index] == 0) {
+        memory->empty[slot] |= mask;
+    } else {
+        memory->empty[slot] &= ~mask;
+    }
+}
+
+/*
+    * Set or clear a contiguous range of memory units.
+    *
+    * @param memory The bitmap memory
+    * @param start The first unit of the range
+    * @param length The number of units in the range
+    * @param allocated True to mark the range as allocated, false to mark it as free
+    */
+static void mark_range(bitmap_mem_t *memory, unsigned int start, unsigned int length, bool allocated) {
+    unsigned int end = start + length;
+
+    while (start < end) {
+        unsigned int index = start / WORD_BITS;
+        unsigned int offset = start % WORD_BITS;
+        unsigned int bits = WORD_BITS - offset;
+        if (bits > end - start) {
+            bits = end - start;
+        }
+        uint64_t mask = (bits == WORD_BITS) ? ALL_ONES : (((uint64_t) 1 << bits) - 1) << offset;
+
+        if (allocated) {
+            memory->words[index] |= mask;
+        } else {
+            memory->words[index] &= ~mask;
+        }
+        update_summary(memory, index);
+        start += bits;
+    }
+}
+
+/*
+    * Find the first free unit at or after pos.
+    *
+    * @param memory The bitmap memory
+    * @param pos The position to start searching from
+    * @return The first free unit, or the memory size if there is none
+    */
+static unsigned int next_free_unit(const bitmap_mem_t *memory, unsigned int pos) {
+    if (pos >= memory->size) {
+        return memory->size;
+    }
+
+    // Check the rest of the current word first
+    unsigned int index = pos / WORD_BITS;
+    uint64_t word = ~memory->words[index] & (ALL_ONES << (pos % WORD_BITS));
+    if (!word) {
+        // Skip the fully allocated words using the summary level
+        index = find_next_bit(memory->full, memory->word_count, index + 1, false);
+        if (index == memory->word_count) {
+            return memory->size;
+        }
+        word = ~memory->words[index];
+    }
+
+    unsigned int found = index * WORD_BITS + __builtin_ctzll(word);
+    return found < memory->size ? found : memory->size;
+}
+
+/*
+    * Find the first allocated unit at or after pos.
+    *
+    * @param memory The bitmap memory
+    * @param pos The position to start searching from
+    * @return The first allocated unit, or the memory size if there is none
+    */
+static unsigned int next_used_unit(const bitmap_mem_t *memory, unsigned int pos) {
+    if (pos >= memory->size) {
+        return memory->size;
+    }
+
+    // Check the rest of the current word first
+    unsigned int index = pos / WORD_BITS;
+    uint64_t word = memory->words[index] & (ALL_ONES << (pos % WORD_BITS));
+    if (!word) {
+        // Skip the fully free words using the summary level
+        index = find_next_bit(memory->empty, memory->word_count, index + 1, false);
+        if (index == memory->word_count) {
+            return memory->size;
+        }
+        word = memory->words[index];
+    }
+
+    unsigned int found = index * WORD_BITS + __builtin_ctzll(word);
+    return found < memory->size ? found : memory->size;
+}
+
+/*
+    * Find the last bit before pos that is set (or clear) in the given bit array.
+    * Whole words are tested at once, so runs of uninteresting bits are skipped 64 at a time.
+    *
+    * @param bits The bit array
+    * @param pos The position to search back from (exclusive)
+    * @param want_set True to look for a set bit, false to look for a clear bit
+    * @return The index of the bit found, or UINT_MAX if there is none
+    */
+static unsigned int find_prev_bit(const uint64_t *bits, unsigned int pos, bool want_set) {
+    while (pos > 0) {
+        unsigned int index = (pos - 1) / WORD_BITS;
+        unsigned int count = pos - index * WORD_BITS;
+        uint64_t word = want_set ? bits[index] : ~bits[index];
+        if (count < WORD_BITS) {
+            word &= ((uint64_t) 1 << count) - 1;
+        }
+        if (word) {
+            return index * WORD_BITS + (WORD_BITS - 1 - __builtin_clzll(word));
+        }
+        pos = index * WORD_BITS;
+    }
+    return UINT_MAX;
+}
+
+/*
+    * Find the end of the allocated run that ends before pos, scanning backwards.
+    *
+    * @param memory The bitmap memory
+    * @param pos The position to scan back from (exclusive)
+    * @return The unit after the last allocated unit before pos, or 0 if there is none
+    */
+static unsigned int prev_used_end(const bitmap_mem_t *memory, unsigned int pos) {
+    if (pos == 0) {
+        return 0;
+    }
+
+    // Check the start of the current word first
+    unsigned int index = (pos - 1) / WORD_BITS;
+    unsigned int count = pos - index * WORD_BITS;
+    uint64_t word = memory->words[index];
+    if (count < WORD_BITS) {
+        word &= ((uint64_t) 1 << count) - 1;
+    }
+    if (!word) {
+        // Skip the fully free words using the summary level
+        index = find_prev_bit(memory->empty, index, false);
+        if (index == UINT_MAX) {
+            return 0;
+        }
+        word = memory->words[index];
+    }
+
+    return index * WORD_BITS + (WORD_BITS - __builtin_clzll(word));
+}
+
+/*
+    * Initializes the bitmap memory with the given size.
+    *
+    * @param size The size of the simulated memory
+    * @return The bitmap memory, or NULL if it could not be allocated
+    */
+bitmap_mem_t *init_bitmap_mem(unsigned int size) {
+    bitmap_mem_t *memory = (bitmap_mem_t *) malloc(sizeof(bitmap_mem_t));
+    unsigned int summary_count;
+
+    if (!memory) {
+        return NULL;
+    }
+    memory->size = size;
+    memory->word_count = (size + WORD_BITS - 1) / WORD_BITS;
+    summary_count = (memory->word_count + WORD_BITS - 1) / WORD_BITS;
+    memory->words = (uint64_t *) calloc(memory->word_count ? memory->word_count : 1, sizeof(uint64_t));
+    memory->full = (uint64_t *) calloc(summary_count ? summary_count : 1, sizeof(uint64_t));
+    memory->empty = (uint64_t *) calloc(summary_count ? summary_count : 1, sizeof(uint64_t));
+    if (!memory->words || !memory->full || !memory->empty) {
+        free_bitmap_mem(memory);
+        return NULL;
+    }
+
+    // Mark the padding bits past the end of memory as allocated so they never form a free run
+    if (size % WORD_BITS) {
+        memory->words[memory->word_count - 1] = ALL_ONES << (size % WORD_BITS);
+    }
+    refresh_bitmap_summary(memory);
+    return memory;
+}
+
+/*
+    * Rebuilds the summary level after the words have been written directly.
+    * The padding bits past the end of memory are marked as allocated again.
+    *
+    * @param memory The bitmap memory
+    */
+void refresh_bitmap_summary(bitmap_mem_t *memory) {
+    if (memory->size % WORD_BITS) {
+        memory->words[memory->word_count - 1] |= ALL_ONES << (memory->size % WORD_BITS);
+    }
+    for (unsigned int i = 0; i < memory->word_count; i++) {
+        update_summary(memory, i);
+    }
+}
+
+/*
+    * Frees the given bitmap memory.
+    *
+    * @param memory The bitmap memory
+    */
+void free_bitmap_mem(bitmap_mem_t *memory) {
+    if (!memory) {
+        return;
+    }
+    free(memory->words);
+    free(memory->full);
+    free(memory->empty);
+    free(memory);
+}
+
+/*
+    * Simulates the best fit memory allocation algorithm on the bitmap.
+    * Free runs are visited in address order, so ties are broken the same way as best_fit_alloc.
+    *
+    * @param memory The bitmap memory
+    * @param process The process to allocate memory for
+    * @param stats The memory statistics to update
+    * @return True if memory was allocated for the process, false otherwise
+    */
+bool bitmap_alloc(bitmap_mem_t *memory, Process *process, mem_stats_t *stats) {
+    unsigned int process_size = process->memory_requirement;
+    unsigned int best_start = 0;
+    unsigned int best_length = 0;
+    // The minimum difference between the run length and the process size
+    unsigned int min_diff = UINT_MAX;
+    bool found = false;
+    unsigned int pos = 0;
+
+    // Find the best fit among the free runs
+    while (pos < memory->size) {
+        unsigned int run_start = next_free_unit(memory, pos);
+        if (run_start >= memory->size) {
+            break;
+        }
+        unsigned int run_end = next_used_unit(memory, run_start);
+        unsigned int run_length = run_end - run_start;
+
+        if (run_length >= process_size && run_length - process_size < min_diff) {
+            best_start = run_start;
+            best_length = run_length;
+            min_diff = run_length - process_size;
+            found = true;
+            // An exact fit cannot be beaten
+            if (min_diff == 0) {
+                break;
+            }
+        }
+        pos = run_end;
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    // Allocate memory for the process
+    mark_range(memory, best_start, process_size, true);
+    mem_stats_remove_hole(stats, best_length);
+    mem_stats_add_hole(stats, best_length - process_size);
+    mem_stats_use(stats, process_size);
+
+    process->memory_start = best_start;
+    return true;
+}
+
+/*
+    * Collects the free runs of the bitmap in address order with a single scan.
+    *
+    * @param memory The bitmap memory
+    * @param count The number of runs found
+    * @return The free runs, or NULL if they could not be allocated
+    */
+static free_run_t *collect_free_runs(const bitmap_mem_t *memory, unsigned int *count) {
+    unsigned int capacity = 16;
+    free_run_t *runs = (free_run_t *) malloc(capacity * sizeof(free_run_t));
+    unsigned int pos = 0;
+
+    *count = 0;
+    while (runs && pos < memory->size) {
+        unsigned int run_start = next_free_unit(memory, pos);
+        if (run_start >= memory->size) {
+            break;
+        }
+        unsigned int run_end = next_used_unit(memory, run_start);
+        if (*count == capacity) {
+            capacity *= 2;
+            free_run_t *grown = (free_run_t *) realloc(runs, capacity * sizeof(free_run_t));
+            if (!grown) {
+                free(runs);
+                return NULL;
+            }
+            runs = grown;
+        }
+        runs[*count].start = run_start;
+        runs[*count].length = run_end - run_start;
+        (*count)++;
+        pos = run_end;
+    }
+    return runs;
+}
+
+/*
+    * Allocates memory for the processes of a queue in order, stopping at the first one that does not fit.
+    * The bitmap is scanned once to collect the free runs, then each process only searches those,
+    * and the remainder of a run stays in its place after the process is put at its start.
+    * The placements are the same as calling bitmap_alloc for each process in turn.
+    *
+    * @param memory The bitmap memory
+    * @param queue The processes to allocate memory for
+    * @param stats The memory statistics to update
+    * @return The number of processes at the front of the queue that were allocated memory
+    */
+int bitmap_alloc_batch(bitmap_mem_t *memory, Node *queue, mem_stats_t *stats) {
+    unsigned int run_count;
+    int admitted = 0;
+
+    if (!queue) {
+        return 0;
+    }
+    free_run_t *runs = collect_free_runs(memory, &run_count);
+    if (!runs) {
+        // Fall back to scanning the bitmap for every process
+        for (Node *node = queue; node && bitmap_alloc(memory, node->process, stats); node = node->next) {
+            admitted++;
+        }
+        return admitted;
+    }
+
+    for (Node *node = queue; node; node = node->next) {
+        Process *process = node->process;
+        unsigned int process_size = process->memory_requirement;
+        free_run_t *best_fit = NULL;
+        // The minimum difference between the run length and the process size
+        unsigned int min_diff = UINT_MAX;
+
+        // Find the best fit among the free runs, a run that has been used up is no longer free
+        for (unsigned int i = 0; i < run_count; i++) {
+            if (runs[i].length > 0 && runs[i].length >= process_size && runs[i].length - process_size < min_diff) {
+                best_fit = &runs[i];
+                min_diff = runs[i].length - process_size;
+                // An exact fit cannot be beaten
+                if (min_diff == 0) {
+                    break;
+                }
+            }
+        }
+
+        // No memory available
+        if (!best_fit) {
+            break;
+        }
+
+        mark_range(memory, best_fit->start, process_size, true);
+        mem_stats_remove_hole(stats, best_fit->length);
+        mem_stats_add_hole(stats, best_fit->length - process_size);
+        mem_stats_use(stats, process_size);
+
+        process->memory_start = best_fit->start;
+        best_fit->start += process_size;
+        best_fit->length -= process_size;
+        admitted++;
+    }
+
+    free(runs);
+    return admitted;
+}
+
+/*
+    * Releases the memory allocated to the process.
+    *
+    * @param memory The bitmap memory
+    * @param process The process to release memory for
+    * @param stats The memory statistics to update
+    */
+void bitmap_release(bitmap_mem_t *memory, Process *process, mem_stats_t *stats) {
+    unsigned int start = process->memory_start;
+    unsigned int size = process->memory_requirement;
+
+    // The block is out of range
+    if (start >= memory->size || size > memory->size - start) {
+        return;
+    }
+
+    mark_range(memory, start, size, false);
+
+    // The released block merges with the free runs on either side
+    if (stats) {
+        unsigned int hole_start = prev_used_end(memory, start);
+        unsigned int hole_end = next_used_unit(memory, start + size);
+        mem_stats_remove_hole(stats, start - hole_start);
+        mem_stats_remove_hole(stats, hole_end - (start + size));
+        mem_stats_add_hole(stats, hole_end - hole_start);
+        mem_stats_unuse(stats, size);
+    }
+}
+
+/*
+    * Records every free run of the bitmap in the statistics, used after initializing or restoring memory.
+    *
+    * @param memory The bitmap memory
+    * @param stats The memory statistics to fill in
+    */
+void collect_bitmap_stats(bitmap_mem_t *memory, mem_stats_t *stats) {
+    unsigned int free_units = 0;
+    unsigned int pos = 0;
+
+    while (pos < memory->size) {
+        unsigned int run_start = next_free_unit(memory, pos);
+        if (run_start >= memory->size) {
+            break;
+        }
+        unsigned int run_end = next_used_unit(memory, run_start);
+        mem_stats_add_hole(stats, run_end - run_start);
+        free_units += run_end - run_start;
+        pos = run_end;
+    }
+    mem_stats_use(stats, memory->size - free_units);
+}
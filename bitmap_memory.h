@@ -0,0 +1,32 @@
+#ifndef BITMAP_MEMORY_H
+#define BITMAP_MEMORY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include "simulated_process.h"
+#include "mem_stats.h"
+
+// Bitmap memory structure, one bit per memory unit (set = allocated)
+typedef struct {
+    unsigned int size;
+    unsigned int word_count;
+    uint64_t *words;
+    // Summary level, one bit per word: word is fully allocated
+    uint64_t *full;
+    // Summary level, one bit per word: word is fully free
+    uint64_t *empty;
+} bitmap_mem_t;
+
+// Bitmap memory functions
+bitmap_mem_t *init_bitmap_mem(unsigned int size);
+void free_bitmap_mem(bitmap_mem_t *memory);
+void refresh_bitmap_summary(bitmap_mem_t *memory);
+bool bitmap_alloc(bitmap_mem_t *memory, Process *process, mem_stats_t *stats);
+int bitmap_alloc_batch(bitmap_mem_t *memory, Node *queue, mem_stats_t *stats);
+void bitmap_release(bitmap_mem_t *memory, Process *process, mem_stats_t *stats);
+void collect_bitmap_stats(bitmap_mem_t *memory, mem_stats_t *stats);
+
+#endif // BITMAP_MEMORY_H
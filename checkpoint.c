@@ -0,0 +1,401 @@
+#include "checkpoint.h"
+
+/*
+    * Write a value to the snapshot file.
+    *
+    * @param file The snapshot file
+    * @param value The value to write
+    * @param size The size of the value in bytes
+    * @return True if the value was written, false otherwise
+    */
+static bool write_value(FILE *file, const void *value, size_t size) {
+    return fwrite(value, size, 1, file) == 1;
+}
+
+/*
+    * Read a value from the snapshot file.
+    *
+    * @param file The snapshot file
+    * @param value The value to read into
+    * @param size The size of the value in bytes
+    * @return True if the value was read, false otherwise
+    */
+static bool read_value(FILE *file, void *value, size_t size) {
+    return fread(value, size, 1, file) == 1;
+}
+
+/*
+    * Write a queue as its length followed by the index of each process.
+    *
+    * @param file The snapshot file
+    * @param head The head of the queue
+    * @param processes The array of processes
+    * @return True if the queue was written, false otherwise
+    */
+static bool write_queue(FILE *file, Node *head, Process *processes) {
+    uint32_t count = count_process(head);
+    bool ok = write_value(file, &count, sizeof(count));
+
+    for (Node *current = head; current && ok; current = current->next) {
+        uint32_t index = current->process - processes;
+        ok = write_value(file, &index, sizeof(index));
+    }
+    return ok;
+}
+
+/*
+    * Read a queue written by write_queue.
+    *
+    * @param file The snapshot file
+    * @param head The head of the queue to rebuild
+    * @param processes The array of processes
+    * @param process_count The number of processes
+    * @return True if the queue was read, false otherwise
+    */
+static bool read_queue(FILE *file, Node **head, Process *processes, int process_count) {
+    uint32_t count;
+    Node **tail = head;
+
+    if (!read_value(file, &count, sizeof(count))) {
+        return false;
+    }
+
+    // Append through a tail pointer so large queues are rebuilt in linear time
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index;
+        if (!read_value(file, &index, sizeof(index)) || index >= (uint32_t) process_count) {
+            return false;
+        }
+        Node *node = (Node *) malloc(sizeof(Node));
+        if (!node) {
+            return false;
+        }
+        node->process = &processes[index];
+        node->next = NULL;
+        *tail = node;
+        tail = &node->next;
+    }
+    return true;
+}
+
+/*
+    * Write the real process path as its length followed by its characters, a length of 0 for none.
+    *
+    * @param file The snapshot file
+    * @param process_path The path to the real process binary, or NULL
+    * @return True if the path was written, false otherwise
+    */
+static bool write_process_path(FILE *file, const char *process_path) {
+    uint32_t length = process_path ? strlen(process_path) : 0;
+    return write_value(file, &length, sizeof(length)) && (length == 0 || write_value(file, process_path, length));
+}
+
+/*
+    * Read the real process path written by write_process_path.
+    *
+    * @param file The snapshot file
+    * @param simulation The simulation state
+    * @return True if the path was read, false otherwise
+    */
+static bool read_process_path(FILE *file, Simulation *simulation) {
+    uint32_t length;
+    char *process_path;
+
+    if (!read_value(file, &length, sizeof(length)) || length > PATH_MAX) {
+        return false;
+    }
+    if (length == 0) {
+        set_process_path(simulation, NULL);
+        return true;
+    }
+    process_path = (char *) calloc(length + 1, 1);
+    if (!process_path) {
+        return false;
+    }
+    bool ok = read_value(file, process_path, length);
+    if (ok) {
+        set_process_path(simulation, process_path);
+    }
+    free(process_path);
+    return ok;
+}
+
+/*
+    * Write the memory state of the simulation.
+    *
+    * @param file The snapshot file
+    * @param simulation The simulation state
+    * @return True if the memory was written, false otherwise
+    */
+static bool write_memory(FILE *file, Simulation *simulation) {
+    bool ok = true;
+
+    if (simulation->config.memory_strategy != PROCSIM_INFINITE) {
+        ok = write_value(file, &simulation->mem_stats.admission_failures, sizeof(simulation->mem_stats.admission_failures));
+    }
+
+    if (simulation->config.memory_strategy == PROCSIM_BEST_FIT) {
+        uint32_t count = 0;
+        for (mem_block_t *block = simulation->memory; block; block = block->next) {
+            count++;
+        }
+        ok = ok && write_value(file, &count, sizeof(count));
+        for (mem_block_t *block = simulation->memory; block && ok; block = block->next) {
+            uint32_t fields[3] = {block->start, block->size, block->is_allocated};
+            ok = write_value(file, fields, sizeof(fields));
+        }
+    } else if (simulation->config.memory_strategy == PROCSIM_BITMAP) {
+        bitmap_mem_t *bitmap = simulation->bitmap;
+        ok = ok && write_value(file, &bitmap->size, sizeof(bitmap->size)) &&
+        fwrite(bitmap->words, sizeof(uint64_t), bitmap->word_count, file) == bitmap->word_count;
+    }
+    return ok;
+}
+
+/*
+    * Read the memory state written by write_memory and rebuild its statistics.
+    *
+    * @param file The snapshot file
+    * @param simulation The simulation state
+    * @return True if the memory was read, false otherwise
+    */
+static bool read_memory(FILE *file, Simulation *simulation) {
+    unsigned long admission_failures = 0;
+
+    if (simulation->config.memory_strategy != PROCSIM_INFINITE &&
+    !read_value(file, &admission_failures, sizeof(admission_failures))) {
+        return false;
+    }
+
+    if (simulation->config.memory_strategy == PROCSIM_BEST_FIT) {
+        unsigned int size = 0;
+        uint32_t count;
+        mem_block_t **tail = &simulation->memory;
+
+        if (!read_value(file, &count, sizeof(count))) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t fields[3];
+            // The blocks have to cover the memory without gaps or overlaps
+            if (!read_value(file, fields, sizeof(fields)) || fields[0] != size ||
+            fields[1] > simulation->config.memory_size - size) {
+                return false;
+            }
+            mem_block_t *block = (mem_block_t *) malloc(sizeof(mem_block_t));
+            if (!block) {
+                return false;
+            }
+            block->start = fields[0];
+            block->size = fields[1];
+            block->is_allocated = fields[2];
+            block->next = NULL;
+            *tail = block;
+            tail = &block->next;
+            size = block->start + block->size;
+        }
+        if (size != simulation->config.memory_size) {
+            return false;
+        }
+        init_mem_stats(&simulation->mem_stats, size);
+        collect_mem_stats(simulation->memory, &simulation->mem_stats);
+    } else if (simulation->config.memory_strategy == PROCSIM_BITMAP) {
+        unsigned int size;
+
+        if (!read_value(file, &size, sizeof(size)) || size != simulation->config.memory_size) {
+            return false;
+        }
+        simulation->bitmap = init_bitmap_mem(size);
+        bitmap_mem_t *bitmap = simulation->bitmap;
+        if (!bitmap || fread(bitmap->words, sizeof(uint64_t), bitmap->word_count, file) != bitmap->word_count) {
+            return false;
+        }
+        refresh_bitmap_summary(bitmap);
+        init_mem_stats(&simulation->mem_stats, size);
+        collect_bitmap_stats(bitmap, &simulation->mem_stats);
+    }
+    simulation->mem_stats.admission_failures = admission_failures;
+    return true;
+}
+
+/*
+    * Save a snapshot of the simulation state.
+    * The snapshot is written to a temporary file and renamed over the target,
+    * so an interrupted write never replaces the previous snapshot.
+    *
+    * @param filename The path to the snapshot file
+    * @param simulation The simulation state
+    * @return True if the snapshot was saved, false otherwise
+    */
+bool save_checkpoint(const char *filename, Simulation *simulation) {
+    size_t length = strlen(filename);
+    char *temp_filename = (char *) malloc(length + sizeof(".tmp"));
+    uint32_t header[2] = {CHECKPOINT_MAGIC, CHECKPOINT_VERSION};
+    int32_t running_index = simulation->current_running_process ?
+    (int32_t) (simulation->current_running_process - simulation->processes) : -1;
+    int32_t fields[12] = {simulation->config.scheduler, simulation->config.memory_strategy, simulation->config.quantum,
+    simulation->config.memory_size, simulation->quantum, simulation->process_count, simulation->process_count_finished,
+    simulation->current_time, simulation->current_index, running_index, simulation->config.perf_counters,
+    simulation->config.max_quantum};
+    double statistics[5] = {simulation->total_turnaround_time, simulation->max_time_overhead,
+    simulation->total_time_overhead, simulation->config.adaptive_target, simulation->config.time_unit_ms};
+
+    if (!temp_filename) {
+        return false;
+    }
+    snprintf(temp_filename, length + sizeof(".tmp"), "%s.tmp", filename);
+    FILE *file = fopen(temp_filename, "wb");
+    if (!file) {
+        free(temp_filename);
+        return false;
+    }
+
+    bool ok = write_value(file, header, sizeof(header)) && write_value(file, fields, sizeof(fields)) &&
+    write_value(file, statistics, sizeof(statistics)) && write_process_path(file, simulation->process_path);
+
+    // Write the processes, remembering which ones have a child process
+    for (int i = 0; i < simulation->process_count && ok; i++) {
+        Process *process = &simulation->processes[i];
+        uint32_t values[5] = {process->time_arrived, process->service_time, process->memory_requirement,
+        (uint32_t) process->remaining_time, process->memory_start};
+        // A finished process keeps no child, only the running one may have no time left
+        uint8_t started = process->pid != 0 &&
+        (process->remaining_time > 0 || process == simulation->current_running_process);
+        ok = write_value(file, values, sizeof(values)) &&
+        write_value(file, process->process_name, sizeof(process->process_name)) &&
+        write_value(file, &started, sizeof(started));
+    }
+
+    ok = ok && write_queue(file, simulation->input_queue, simulation->processes) &&
+    write_queue(file, simulation->ready_queue, simulation->processes) && write_memory(file, simulation);
+
+    // Make sure the snapshot is on disk before it replaces the previous one
+    ok = fflush(file) == 0 && fsync(fileno(file)) == 0 && ok;
+    ok = fclose(file) == 0 && ok;
+    if (ok && rename(temp_filename, filename) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        unlink(temp_filename);
+    }
+    free(temp_filename);
+    return ok;
+}
+
+/*
+    * Load a snapshot of the simulation state.
+    * Child processes are not part of the snapshot; call respawn_processes to recreate them.
+    *
+    * @param filename The path to the snapshot file
+    * @param simulation The simulation state to fill in
+    * @return True if the snapshot was loaded, false otherwise
+    */
+bool load_checkpoint(const char *filename, Simulation *simulation) {
+    uint32_t header[2];
+    int32_t fields[12];
+    double statistics[5];
+    FILE *file = fopen(filename, "rb");
+
+    if (!file) {
+        return false;
+    }
+
+    // Check the header before trusting the rest of the file
+    if (!read_value(file, header, sizeof(header)) || header[0] != CHECKPOINT_MAGIC ||
+    header[1] != CHECKPOINT_VERSION || !read_value(file, fields, sizeof(fields)) ||
+    !read_value(file, statistics, sizeof(statistics)) || fields[5] < 0 || fields[9] < -1 || fields[9] >= fields[5] ||
+    !read_process_path(file, simulation)) {
+        fclose(file);
+        return false;
+    }
+
+    simulation->config.scheduler = fields[0];
+    simulation->config.memory_strategy = fields[1];
+    simulation->config.quantum = fields[2];
+    simulation->config.memory_size = fields[3];
+    simulation->quantum = fields[4];
+    simulation->process_count = fields[5];
+    simulation->process_count_finished = fields[6];
+    simulation->current_time = fields[7];
+    simulation->current_index = fields[8];
+    simulation->total_turnaround_time = statistics[0];
+    simulation->max_time_overhead = statistics[1];
+    simulation->total_time_overhead = statistics[2];
+    simulation->config.adaptive_target = statistics[3];
+    simulation->config.time_unit_ms = statistics[4];
+    simulation->config.perf_counters = fields[10] != 0;
+    simulation->config.max_quantum = fields[11];
+
+    // A damaged snapshot must fail to load rather than hang or crash the simulator
+    if (!valid_config(&simulation->config) || simulation->config.memory_size == 0 || simulation->quantum < 1 ||
+    simulation->current_time < 0 || simulation->current_index < 0 ||
+    simulation->current_index > simulation->process_count || simulation->process_count_finished < 0 ||
+    simulation->process_count_finished > simulation->process_count) {
+        fclose(file);
+        return false;
+    }
+    simulation->processes = (Process *) calloc(simulation->process_count ? simulation->process_count : 1, sizeof(Process));
+    if (!simulation->processes) {
+        fclose(file);
+        return false;
+    }
+
+    bool finite_memory = simulation->config.memory_strategy != PROCSIM_INFINITE;
+    bool ok = true;
+    for (int i = 0; i < simulation->process_count && ok; i++) {
+        Process *process = &simulation->processes[i];
+        uint32_t values[5];
+        uint8_t started;
+        ok = read_value(file, values, sizeof(values)) &&
+        read_value(file, process->process_name, sizeof(process->process_name)) &&
+        read_value(file, &started, sizeof(started));
+        process->time_arrived = values[0];
+        process->service_time = values[1];
+        process->memory_requirement = values[2];
+        process->remaining_time = (int) values[3];
+        process->memory_start = values[4];
+        process->process_name[MAX_PROCESS_NAME_LENGTH] = '\0';
+        // The memory of a process has to lie inside the memory it is released to
+        if (finite_memory && (values[2] > simulation->config.memory_size ||
+        values[4] > simulation->config.memory_size - values[2])) {
+            ok = false;
+        }
+        process->collect_perf = simulation->config.perf_counters;
+        // Mark the process as started until respawn_processes creates its new child
+        process->pid = started ? -1 : 0;
+    }
+
+    simulation->current_running_process = fields[9] >= 0 ? &simulation->processes[fields[9]] : NULL;
+    ok = ok && read_queue(file, &simulation->input_queue, simulation->processes, simulation->process_count) &&
+    read_queue(file, &simulation->ready_queue, simulation->processes, simulation->process_count) &&
+    read_memory(file, simulation);
+    fclose(file);
+    return ok;
+}
+
+/*
+    * Recreate the child processes of the processes that had started before the snapshot.
+    * The running process is left running and every other started process is suspended,
+    * matching the state the scheduler expects.
+    *
+    * @param simulation The simulation state
+    * @return True if every child was recreated, false otherwise
+    */
+bool respawn_processes(Simulation *simulation) {
+    for (int i = 0; i < simulation->process_count; i++) {
+        Process *process = &simulation->processes[i];
+        // Skip processes that never started and those that already finished
+        if (process->pid == 0 || (process->remaining_time <= 0 && process != simulation->current_running_process)) {
+            process->pid = 0;
+            continue;
+        }
+        if (!create_process(process, simulation->process_path, true, simulation->current_time)) {
+            return false;
+        }
+        if (process != simulation->current_running_process &&
+        !suspend_process(process->pid, process->pipe_fd[1], simulation->current_time)) {
+            return false;
+        }
+    }
+    return true;
+}
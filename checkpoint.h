@@ -0,0 +1,19 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include "simulation.h"
+
+#define CHECKPOINT_MAGIC 0x4b434d50
+#define CHECKPOINT_VERSION 6
+
+// Checkpoint functions
+bool save_checkpoint(const char *filename, Simulation *simulation);
+bool load_checkpoint(const char *filename, Simulation *simulation);
+bool respawn_processes(Simulation *simulation);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,97 @@
+#include "events.h"
+
+/*
+    * Deliver an event to the registered callback, if any.
+    *
+    * @param sink The event sink
+    * @param event The event to deliver
+    */
+static void emit(const event_sink_t *sink, const procsim_event_t *event) {
+    if (sink && sink->callback) {
+        sink->callback(event, sink->user_data);
+    }
+}
+
+/*
+    * Emit the event of a process that has been allocated memory.
+    *
+    * @param sink The event sink
+    * @param current_time The current time
+    * @param process The process that is ready
+    */
+void emit_ready(const event_sink_t *sink, int current_time, Process *process) {
+    procsim_event_t event = {0};
+    event.type = PROCSIM_EVENT_READY;
+    event.time = current_time;
+    event.process_name = process->process_name;
+    event.assigned_at = process->memory_start;
+    emit(sink, &event);
+}
+
+/*
+    * Emit the event of a process that has been given the CPU.
+    *
+    * @param sink The event sink
+    * @param current_time The current time
+    * @param process The process that is running
+    * @param quantum The length of the slice
+    */
+void emit_running(const event_sink_t *sink, int current_time, Process *process, int quantum) {
+    procsim_event_t event = {0};
+    event.type = PROCSIM_EVENT_RUNNING;
+    event.time = current_time;
+    event.process_name = process->process_name;
+    event.remaining_time = process->remaining_time;
+    event.quantum = quantum;
+    emit(sink, &event);
+}
+
+/*
+    * Emit the event of a process that has finished.
+    *
+    * @param sink The event sink
+    * @param current_time The current time
+    * @param process The process that has finished
+    * @param proc_remaining The number of processes still waiting
+    */
+void emit_finished(const event_sink_t *sink, int current_time, Process *process, int proc_remaining) {
+    procsim_event_t event = {0};
+    event.type = PROCSIM_EVENT_FINISHED;
+    event.time = current_time;
+    event.process_name = process->process_name;
+    event.proc_remaining = proc_remaining;
+    emit(sink, &event);
+}
+
+/*
+    * Emit the digest reported by a real process that has finished.
+    *
+    * @param sink The event sink
+    * @param current_time The current time
+    * @param process The process that has finished
+    */
+void emit_finished_process(const event_sink_t *sink, int current_time, Process *process) {
+    procsim_event_t event = {0};
+    event.type = PROCSIM_EVENT_FINISHED_PROCESS;
+    event.time = current_time;
+    event.process_name = process->process_name;
+    event.sha256_digest = process->sha256_digest;
+    emit(sink, &event);
+}
+
+/*
+    * Emit the resources consumed by a real process that has finished.
+    *
+    * @param sink The event sink
+    * @param current_time The current time
+    * @param process The process that has finished
+    */
+void emit_usage(const event_sink_t *sink, int current_time, Process *process) {
+    procsim_event_t event = {0};
+    event.type = PROCSIM_EVENT_USAGE;
+    event.time = current_time;
+    event.process_name = process->process_name;
+    event.service_time = process->service_time;
+    event.usage = &process->usage;
+    emit(sink, &event);
+}
@@ -0,0 +1,22 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "procsim.h"
+#include "simulated_process.h"
+
+// Destination of the simulation events
+typedef struct {
+    procsim_event_cb callback;
+    void *user_data;
+} event_sink_t;
+
+// Event functions
+void emit_ready(const event_sink_t *sink, int current_time, Process *process);
+void emit_running(const event_sink_t *sink, int current_time, Process *process, int quantum);
+void emit_finished(const event_sink_t *sink, int current_time, Process *process, int proc_remaining);
+void emit_finished_process(const event_sink_t *sink, int current_time, Process *process);
+void emit_usage(const event_sink_t *sink, int current_time, Process *process);
+
+#endif // EVENTS_H
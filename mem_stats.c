@@ -0,0 +1,164 @@
+#include "mem_stats.h"
+
+#define INITIAL_HOLE_SIZE_CAPACITY 16
+
+/*
+    * Initializes the statistics for a memory of the given size with no holes recorded.
+    *
+    * @param stats The memory statistics
+    * @param size The size of the simulated memory
+    */
+void init_mem_stats(mem_stats_t *stats, unsigned int size) {
+    stats->total = size;
+    stats->used = 0;
+    stats->free_holes = 0;
+    stats->largest_hole = 0;
+    stats->hole_sizes = NULL;
+    stats->hole_size_count = 0;
+    stats->hole_size_capacity = 0;
+    stats->admission_failures = 0;
+}
+
+/*
+    * Frees the hole sizes of the statistics.
+    *
+    * @param stats The memory statistics
+    */
+void free_mem_stats(mem_stats_t *stats) {
+    if (!stats) {
+        return;
+    }
+    free(stats->hole_sizes);
+    stats->hole_sizes = NULL;
+    stats->hole_size_count = 0;
+    stats->hole_size_capacity = 0;
+}
+
+/*
+    * Finds the position of a hole size, or where it would be inserted.
+    *
+    * @param stats The memory statistics
+    * @param size The size of the hole
+    * @return The index of the first recorded size that is not smaller than size
+    */
+static unsigned int find_hole_size(const mem_stats_t *stats, unsigned int size) {
+    unsigned int low = 0, high = stats->hole_size_count;
+
+    while (low < high) {
+        unsigned int middle = low + (high - low) / 2;
+        if (stats->hole_sizes[middle].size < size) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/*
+    * Records a new free hole. Empty holes are ignored.
+    *
+    * @param stats The memory statistics
+    * @param size The size of the hole
+    */
+void mem_stats_add_hole(mem_stats_t *stats, unsigned int size) {
+    if (!stats || size == 0 || size > stats->total) {
+        return;
+    }
+    unsigned int index = find_hole_size(stats, size);
+
+    if (index == stats->hole_size_count || stats->hole_sizes[index].size != size) {
+        // First hole of this size, grow the array if needed and shift the larger sizes up
+        if (stats->hole_size_count == stats->hole_size_capacity) {
+            unsigned int capacity = stats->hole_size_capacity ? stats->hole_size_capacity * 2 : INITIAL_HOLE_SIZE_CAPACITY;
+            hole_size_t *hole_sizes = (hole_size_t *) realloc(stats->hole_sizes, capacity * sizeof(hole_size_t));
+            if (!hole_sizes) {
+                return;
+            }
+            stats->hole_sizes = hole_sizes;
+            stats->hole_size_capacity = capacity;
+        }
+        memmove(&stats->hole_sizes[index + 1], &stats->hole_sizes[index],
+        (stats->hole_size_count - index) * sizeof(hole_size_t));
+        stats->hole_sizes[index].size = size;
+        stats->hole_sizes[index].count = 0;
+        stats->hole_size_count++;
+    }
+    stats->hole_sizes[index].count++;
+    stats->free_holes++;
+    stats->largest_hole = stats->hole_sizes[stats->hole_size_count - 1].size;
+}
+
+/*
+    * Forgets a free hole that has been allocated or merged.
+    *
+    * @param stats The memory statistics
+    * @param size The size of the hole
+    */
+void mem_stats_remove_hole(mem_stats_t *stats, unsigned int size) {
+    if (!stats || size == 0 || size > stats->total) {
+        return;
+    }
+    unsigned int index = find_hole_size(stats, size);
+
+    if (index == stats->hole_size_count || stats->hole_sizes[index].size != size) {
+        return;
+    }
+    stats->free_holes--;
+    if (--stats->hole_sizes[index].count == 0) {
+        // Last hole of this size, the next smaller size becomes the largest if this was the largest
+        stats->hole_size_count--;
+        memmove(&stats->hole_sizes[index], &stats->hole_sizes[index + 1],
+        (stats->hole_size_count - index) * sizeof(hole_size_t));
+    }
+    stats->largest_hole = stats->hole_size_count ? stats->hole_sizes[stats->hole_size_count - 1].size : 0;
+}
+
+/*
+    * Records that memory has been allocated.
+    *
+    * @param stats The memory statistics
+    * @param size The number of units allocated
+    */
+void mem_stats_use(mem_stats_t *stats, unsigned int size) {
+    if (stats) {
+        stats->used += size;
+    }
+}
+
+/*
+    * Records that memory has been released.
+    *
+    * @param stats The memory statistics
+    * @param size The number of units released
+    */
+void mem_stats_unuse(mem_stats_t *stats, unsigned int size) {
+    if (stats) {
+        stats->used -= size < stats->used ? size : stats->used;
+    }
+}
+
+/*
+    * Records a process that could not be admitted because no hole was large enough.
+    *
+    * @param stats The memory statistics
+    */
+void mem_stats_admission_failed(mem_stats_t *stats) {
+    if (stats) {
+        stats->admission_failures++;
+    }
+}
+
+/*
+    * Computes the external fragmentation ratio, the share of free memory outside the largest hole.
+    *
+    * @param stats The memory statistics
+    * @return The external fragmentation ratio, 0 when there is no free memory
+    */
+double external_fragmentation(const mem_stats_t *stats) {
+    unsigned int free_units = stats->total - stats->used;
+    if (free_units == 0) {
+        return 0;
+    }
+    return 1.0 - (double) stats->largest_hole / free_units;
+}
@@ -0,0 +1,37 @@
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of free holes of one size
+typedef struct {
+    unsigned int size;
+    unsigned int count;
+} hole_size_t;
+
+// Memory statistics, updated incrementally as blocks are allocated and released
+typedef struct {
+    unsigned int total;
+    unsigned int used;
+    unsigned int free_holes;
+    unsigned int largest_hole;
+    // Distinct sizes of the free holes in ascending order, so the largest is the last
+    hole_size_t *hole_sizes;
+    unsigned int hole_size_count;
+    unsigned int hole_size_capacity;
+    unsigned long admission_failures;
+} mem_stats_t;
+
+// Memory statistics functions
+void init_mem_stats(mem_stats_t *stats, unsigned int size);
+void free_mem_stats(mem_stats_t *stats);
+void mem_stats_add_hole(mem_stats_t *stats, unsigned int size);
+void mem_stats_remove_hole(mem_stats_t *stats, unsigned int size);
+void mem_stats_use(mem_stats_t *stats, unsigned int size);
+void mem_stats_unuse(mem_stats_t *stats, unsigned int size);
+void mem_stats_admission_failed(mem_stats_t *stats);
+double external_fragmentation(const mem_stats_t *stats);
+
+#endif // MEM_STATS_H
@@ -4,10 +4,13 @@
     * Initializes the memory with the given size.
     * 
     * @param size The size of the simulated memory
-    * @return The head of the memory linked list
+    * @return The head of the memory linked list, or NULL if it could not be allocated
     */
 mem_block_t *init_mem(unsigned int size) {
     mem_block_t *mem = (mem_block_t *) malloc(sizeof(mem_block_t));
+    if (!mem) {
+        return NULL;
+    }
     mem->start = 0;
     mem->size = size;
     mem->next = NULL;
@@ -35,12 +38,11 @@ void free_mem(mem_block_t *memory) {
     *
     * @param memory The head of the memory linked list
     * @param process The process to allocate memory for
-    * @param current_time The current time
+    * @param stats The memory statistics to update
     * @return The memory block allocated for the process
     */
-mem_block_t *best_fit_alloc(mem_block_t *memory, Process *process, int current_time) {
+mem_block_t *best_fit_alloc(mem_block_t *memory, Process *process, mem_stats_t *stats) {
     unsigned int process_size = process->memory_requirement;
-    const char *process_name = process->process_name;
     mem_block_t *best_fit = NULL;
     // The minimum difference between the block size and the process size
     unsigned int min_diff = UINT_MAX;
@@ -61,6 +63,11 @@ mem_block_t *best_fit_alloc(mem_block_t *memory, Process *process, int current_t
 
     // Allocate memory for the process
     if (best_fit) {
+        // The hole is replaced by whatever is left after the split
+        mem_stats_remove_hole(stats, best_fit->size);
+        mem_stats_add_hole(stats, best_fit->size - process_size);
+        mem_stats_use(stats, process_size);
+
         mem_block_t *new_block = (mem_block_t *) malloc(sizeof(mem_block_t));
         new_block->start = best_fit->start + process_size;
         new_block->size = best_fit->size - process_size;
@@ -72,21 +79,99 @@ mem_block_t *best_fit_alloc(mem_block_t *memory, Process *process, int current_t
         best_fit->is_allocated = 1;
         best_fit->next = new_block;
 
-        // Print the event
-        printf("%u,READY,process_name=%s,assigned_at=%u\n", current_time, process_name, best_fit->start);
         process->memory_start = best_fit->start;
     }
 
     return best_fit;
 }
 
+/*
+    * Simulates best fit for the processes of a queue in order, stopping at the first one that does not fit.
+    * The block list is walked once to collect the free blocks, then each process only searches those,
+    * so a burst of arrivals does not rescan the growing list of allocated blocks.
+    * The placements are the same as calling best_fit_alloc for each process in turn.
+    *
+    * @param memory The head of the memory linked list
+    * @param queue The processes to allocate memory for
+    * @param stats The memory statistics to update
+    * @return The number of processes at the front of the queue that were allocated memory
+    */
+int best_fit_alloc_batch(mem_block_t *memory, Node *queue, mem_stats_t *stats) {
+    int hole_count = 0;
+    int admitted = 0;
+
+    if (!queue) {
+        return 0;
+    }
+
+    // Collect the free blocks in address order
+    for (mem_block_t *current = memory; current; current = current->next) {
+        if (!current->is_allocated) {
+            hole_count++;
+        }
+    }
+    mem_block_t **holes = (mem_block_t **) malloc((hole_count ? hole_count : 1) * sizeof(mem_block_t *));
+    hole_count = 0;
+    for (mem_block_t *current = memory; current; current = current->next) {
+        if (!current->is_allocated) {
+            holes[hole_count++] = current;
+        }
+    }
+
+    for (Node *node = queue; node; node = node->next) {
+        Process *process = node->process;
+        unsigned int process_size = process->memory_requirement;
+        int best_fit = -1;
+        // The minimum difference between the block size and the process size
+        unsigned int min_diff = UINT_MAX;
+
+        // Find the best fit among the free blocks
+        for (int i = 0; i < hole_count; i++) {
+            if (holes[i]->size >= process_size && holes[i]->size - process_size < min_diff) {
+                best_fit = i;
+                min_diff = holes[i]->size - process_size;
+            }
+        }
+
+        // No memory available
+        if (best_fit < 0) {
+            break;
+        }
+
+        // Split the block, the remainder takes its place among the free blocks
+        mem_block_t *block = holes[best_fit];
+        mem_stats_remove_hole(stats, block->size);
+        mem_stats_add_hole(stats, block->size - process_size);
+        mem_stats_use(stats, process_size);
+
+        mem_block_t *new_block = (mem_block_t *) malloc(sizeof(mem_block_t));
+        new_block->start = block->start + process_size;
+        new_block->size = block->size - process_size;
+        new_block->is_allocated = 0;
+        new_block->next = block->next;
+
+        block->size = process_size;
+        // mark the block as allocated
+        block->is_allocated = 1;
+        block->next = new_block;
+        holes[best_fit] = new_block;
+
+        process->memory_start = block->start;
+        admitted++;
+    }
+
+    free(holes);
+    return admitted;
+}
+
 /*
     * Releases the memory allocated to the process.
     * 
     * @param memory The head of the memory linked list
     * @param process The process to release memory for
+    * @param stats The memory statistics to update
     */
-void release_mem(mem_block_t *memory, Process *process) {
+void release_mem(mem_block_t *memory, Process *process, mem_stats_t *stats) {
     unsigned int start = process->memory_start;
     mem_block_t *current = memory;
     mem_block_t *prev = NULL;
@@ -107,9 +192,11 @@ void release_mem(mem_block_t *memory, Process *process) {
 
     // Mark the block as free
     current->is_allocated = 0;
+    mem_stats_unuse(stats, current->size);
 
     // Merge with previous block
     if (prev && !prev->is_allocated && prev->start + prev->size == current->start) {
+        mem_stats_remove_hole(stats, prev->size);
         prev->size += current->size;
         prev->next = current->next;
         free(current);
@@ -120,8 +207,27 @@ void release_mem(mem_block_t *memory, Process *process) {
     // Merge with next block
     if (current->next && !current->next->is_allocated && current->start + current->size == current->next->start) {
         mem_block_t *next = current->next;
+        mem_stats_remove_hole(stats, next->size);
         current->size += next->size;
         current->next = next->next;
         free(next);
     }
+
+    mem_stats_add_hole(stats, current->size);
+}
+
+/*
+    * Records every block of the memory in the statistics, used after initializing or restoring memory.
+    *
+    * @param memory The head of the memory linked list
+    * @param stats The memory statistics to fill in
+    */
+void collect_mem_stats(mem_block_t *memory, mem_stats_t *stats) {
+    for (mem_block_t *current = memory; current; current = current->next) {
+        if (current->is_allocated) {
+            mem_stats_use(stats, current->size);
+        } else {
+            mem_stats_add_hole(stats, current->size);
+        }
+    }
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include <limits.h>
 #include "simulated_process.h"
+#include "mem_stats.h"
 
 // Memory block structure
 typedef struct mem_block {
@@ -18,7 +19,9 @@ typedef struct mem_block {
 // Memory block functions
 mem_block_t *init_mem(unsigned int size);
 void free_mem(mem_block_t *memory);
-mem_block_t *best_fit_alloc(mem_block_t *memory, Process *process, int current_time);
-void release_mem(mem_block_t *memory, Process *process);
+mem_block_t *best_fit_alloc(mem_block_t *memory, Process *process, mem_stats_t *stats);
+int best_fit_alloc_batch(mem_block_t *memory, Node *queue, mem_stats_t *stats);
+void release_mem(mem_block_t *memory, Process *process, mem_stats_t *stats);
+void collect_mem_stats(mem_block_t *memory, mem_stats_t *stats);
 
 #endif // MEMORY_H
@@ -1,6 +1,5 @@
 #define IMPLEMENTS_REAL_PROCESS
 #include "process_manager.h"
-#define MAX_MEMORY_SIZE 2048
 
 /*
     * Read the command line arguments.
@@ -8,14 +7,38 @@
     * @param argc The number of command line arguments
     * @param argv The array of command line arguments
     * @param filename The path to the input file
-    * @param scheduler The scheduling algorithm
-    * @param memory_strategy The memory allocation strategy
-    * @param quantum The quantum value
+    * @param config The simulator configuration
+    * @param checkpoint_file The path to the periodic snapshot file
+    * @param checkpoint_interval The simulation time between snapshots
+    * @param resume_file The path to the snapshot to resume from
+    * @param mem_stats_file The path to the memory statistics time series
+    * @param mem_stats_interval The simulation time between memory statistics samples
+    * @param report_usage Whether to print the resources consumed by each real process
+    * @param binary_trace_file The path to the binary copy of the event log
     */
-void read_arguments(int argc, char *argv[], char **filename, Scheduler *scheduler, MemoryStrategy *memory_strategy, int *quantum) {
+void read_arguments(int argc, char *argv[], char **filename, procsim_config_t *config,
+char **checkpoint_file, int *checkpoint_interval, char **resume_file, char **mem_stats_file, int *mem_stats_interval,
+bool *report_usage, char **binary_trace_file) {
+    static struct option long_options[] = {
+        {"checkpoint", required_argument, NULL, 'c'},
+        {"checkpoint-interval", required_argument, NULL, 'i'},
+        {"resume", required_argument, NULL, 'r'},
+        {"mem-stats", required_argument, NULL, 'M'},
+        {"mem-stats-interval", required_argument, NULL, 'I'},
+        {"adaptive-quantum", required_argument, NULL, 'a'},
+        {"time-unit-ms", required_argument, NULL, 'u'},
+        {"max-quantum", required_argument, NULL, 'x'},
+        {"usage", no_argument, NULL, 'U'},
+        {"perf", no_argument, NULL, 'P'},
+        {"binary-trace", required_argument, NULL, 'B'},
+        {"memory-size", required_argument, NULL, 'S'},
+        {NULL, 0, NULL, 0}
+    };
     int opt;
+    unsigned long memory_size;
+    char *end;
     // Parse command line arguments
-    while ((opt = getopt(argc, argv, "f:s:m:q:")) != -1) {
+    while ((opt = getopt_long(argc, argv, "f:s:m:q:c:i:", long_options, NULL)) != -1) {
         switch (opt) {
             case 'f':
                 *filename = optarg;
@@ -27,9 +50,9 @@ void read_arguments(int argc, char *argv[], char **filename, Scheduler *schedule
                 break;
             case 's':
                 if (strcmp(optarg, "SJF") == 0) {
-                    *scheduler = SJF;
+                    config->scheduler = PROCSIM_SJF;
                 } else if (strcmp(optarg, "RR") == 0) {
-                    *scheduler = RR;
+                    config->scheduler = PROCSIM_RR;
                 } else {
                     // Check if scheduler is valid
                     fprintf(stderr, "Invalid scheduler option\n");
@@ -38,9 +61,11 @@ void read_arguments(int argc, char *argv[], char **filename, Scheduler *schedule
                 break;
             case 'm':
                 if (strcmp(optarg, "infinite") == 0) {
-                    *memory_strategy = INFINITE;
+                    config->memory_strategy = PROCSIM_INFINITE;
                 } else if (strcmp(optarg, "best-fit") == 0) {
-                    *memory_strategy = BEST_FIT;
+                    config->memory_strategy = PROCSIM_BEST_FIT;
+                } else if (strcmp(optarg, "bitmap") == 0) {
+                    config->memory_strategy = PROCSIM_BITMAP;
                 } else {
                     // Check if memory strategy is valid
                     fprintf(stderr, "Invalid memory strategy option\n");
@@ -48,139 +73,262 @@ void read_arguments(int argc, char *argv[], char **filename, Scheduler *schedule
                 }
                 break;
             case 'q':
-                *quantum = atoi(optarg);
+                config->quantum = atoi(optarg);
                 // Check if quantum is valid
-                if (*quantum < 1 || *quantum > 3) {
+                if (config->quantum < 1 || config->quantum > 3) {
                     fprintf(stderr, "Invalid quantum value\n");
                     exit(EXIT_FAILURE);
                 }
                 break;
+            case 'c':
+                *checkpoint_file = optarg;
+                break;
+            case 'i':
+                *checkpoint_interval = atoi(optarg);
+                // Check if checkpoint interval is valid
+                if (*checkpoint_interval < 1) {
+                    fprintf(stderr, "Invalid checkpoint interval\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'r':
+                *resume_file = optarg;
+                break;
+            case 'M':
+                *mem_stats_file = optarg;
+                break;
+            case 'I':
+                *mem_stats_interval = atoi(optarg);
+                // Check if sampling interval is valid
+                if (*mem_stats_interval < 1) {
+                    fprintf(stderr, "Invalid memory statistics interval\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'a':
+                config->adaptive_target = atof(optarg);
+                // Check if overhead target is a valid percentage
+                if (config->adaptive_target <= 0 || config->adaptive_target > 100) {
+                    fprintf(stderr, "Invalid adaptive quantum target\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'x':
+                config->max_quantum = atoi(optarg);
+                // Check if the longest slice is valid
+                if (config->max_quantum < 1) {
+                    fprintf(stderr, "Invalid maximum quantum\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'u':
+                config->time_unit_ms = atof(optarg);
+                // Check if time unit is valid
+                if (config->time_unit_ms <= 0) {
+                    fprintf(stderr, "Invalid time unit\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'U':
+                *report_usage = true;
+                break;
+            case 'P':
+                // Counters are only useful next to the rest of the usage
+                config->perf_counters = true;
+                *report_usage = true;
+                break;
+            case 'B':
+                *binary_trace_file = optarg;
+                break;
+            case 'S':
+                memory_size = strtoul(optarg, &end, 10);
+                // Check if memory size is a positive number that fits the configuration
+                if (*optarg == '-' || *end != '\0' || memory_size < 1 || memory_size > UINT_MAX) {
+                    fprintf(stderr, "Invalid memory size\n");
+                    exit(EXIT_FAILURE);
+                }
+                config->memory_size = memory_size;
+                break;
             default:
                 // Check if all arguments are provided
-                fprintf(stderr, "Usage: %s -f <filename> -s (SJF | RR) -m (infinite | best-fit) -q (1 | 2 | 3)\n", argv[0]);
+                fprintf(stderr, "Usage: %s -f <filename> -s (SJF | RR) -m (infinite | best-fit | bitmap) -q (1 | 2 | 3) [-c <checkpoint> -i <interval>] [--resume <checkpoint>] [--mem-stats <file> --mem-stats-interval <interval>] [--adaptive-quantum <percent> --max-quantum <q> --time-unit-ms <ms>] [--usage] [--perf] [--binary-trace <file>] [--memory-size <units>]\n", argv[0]);
                 exit(EXIT_FAILURE);
         }
     }
 }
 
 /*
-    * Read the input file and store the processes in the array.
+    * Read the input file and submit the processes to the simulator.
+    * Every non-blank line must hold exactly one process, otherwise the program exits with an error.
     * 
     * @param filename The path to the input file
-    * @param processes The array of processes
-    * @param process_count The number of processes
+    * @param simulation The simulator
     */
-void read_input_file(char *filename, Process **processes, int *process_count) {
+void read_input_file(char *filename, procsim_t *simulation) {
     FILE *file = fopen(filename, "r");
+    long time_arrived, service_time, memory_requirement;
+    // One extra character to detect names that are too long
+    char process_name[PROCSIM_MAX_NAME_LENGTH + 2];
+    char trailing;
+    char *line = NULL;
+    size_t line_capacity = 0;
+    int line_number = 0;
+
     // Check if file exists
     if (!file) {
         fprintf(stderr, "Error opening file: %s\n", filename);
         exit(1);
     }
 
-    // Count the number of processes
-    while (!feof(file)) {
-        if (fgetc(file) == '\n') {
-            (*process_count)++;
+    // Read the processes from the file, one per line
+    while (getline(&line, &line_capacity, file) != -1) {
+        line_number++;
+        // Skip blank lines
+        if (line[strspn(line, " \t\r\n")] == '\0') {
+            continue;
+        }
+        int fields = sscanf(line, "%ld %9s %ld %ld %c", &time_arrived, process_name, &service_time,
+        &memory_requirement, &trailing);
+        if (fields >= 2 && strlen(process_name) > PROCSIM_MAX_NAME_LENGTH) {
+            fprintf(stderr, "Process name longer than %d characters on line %d of %s\n", PROCSIM_MAX_NAME_LENGTH,
+            line_number, filename);
+            exit(1);
+        }
+        // Check if the line has exactly four fields, none of them negative
+        if (fields != 4 || time_arrived < 0 || service_time < 0 || memory_requirement < 0) {
+            fprintf(stderr, "Malformed process on line %d of %s\n", line_number, filename);
+            exit(1);
+        }
+        // Check if the process is valid and in order of arrival
+        if (procsim_add_job(simulation, (unsigned int) time_arrived, process_name, (unsigned int) service_time,
+        (unsigned int) memory_requirement) != 0) {
+            fprintf(stderr, "Invalid process on line %d of %s: %s\n", line_number, filename, process_name);
+            exit(1);
         }
     }
-    
-    // Reset the file pointer
-    rewind(file);
 
-    // Allocate memory for the processes
-    *processes = (Process *)calloc(*process_count, sizeof(Process));
-    // Read the processes from the file
-    for (int i = 0; i < *process_count; i++) {
-        fscanf(file, "%u %s %u %u\n", &(*processes)[i].time_arrived, (*processes)[i].process_name,
-        &(*processes)[i].service_time, &(*processes)[i].memory_requirement);
-        // Set the remaining time to the service time
-        (*processes)[i].remaining_time = (*processes)[i].service_time;
+    // Check if the whole file was read
+    if (ferror(file)) {
+        fprintf(stderr, "Error reading file: %s\n", filename);
+        exit(1);
     }
+    free(line);
     fclose(file);
 }
 
 /*
-    * Terminate the finished process and free the memory.
+    * Print a simulation event.
     *
-    * @param current_running_process The current running process
-    * @param current_time The current time
-    * @param ready_queue The ready queue
-    * @param input_queue The input queue
-    * @param memory The head of the memory block
-    * @param memory_strategy The memory allocation strategy
-*/
-void handle_finished_process(Process *current_running_process, int current_time, Node **ready_queue, Node **input_queue, mem_block_t **memory, MemoryStrategy memory_strategy) {
-    // Terminate the process
-    terminate_process(current_running_process->pid, current_running_process->pipe_fd[1], current_time,
-    current_running_process->pipe_fd[0], current_running_process);
+    * @param event The event
+    * @param user_data The print options
+    */
+void print_event(const procsim_event_t *event, void *user_data) {
+    const print_options_t *options = (const print_options_t *) user_data;
+    const procsim_usage_t *usage = event->usage;
 
-    int proc_remaining = count_process(*ready_queue) + count_process(*input_queue);
-    printf("%d,FINISHED,process_name=%s,proc_remaining=%d\n", 
-    current_time, current_running_process->process_name, proc_remaining);
-    printf("%d,FINISHED-PROCESS,process_name=%s,sha=%s\n",
-    current_time, current_running_process->process_name, current_running_process->sha256_digest);
-    if (memory_strategy == BEST_FIT) {
-        // Free the memory
-        release_mem(*memory, current_running_process);
+    if (options->binary_trace) {
+        write_binary_event(options->binary_trace, event, options->report_quantum);
+    }
+
+    switch (event->type) {
+        case PROCSIM_EVENT_READY:
+            printf("%d,READY,process_name=%s,assigned_at=%u\n", event->time, event->process_name, event->assigned_at);
+            break;
+        case PROCSIM_EVENT_RUNNING:
+            if (options->report_quantum) {
+                printf("%d,RUNNING,process_name=%s,remaining_time=%d,quantum=%d\n", event->time,
+                event->process_name, event->remaining_time, event->quantum);
+            } else {
+                printf("%d,RUNNING,process_name=%s,remaining_time=%d\n", event->time,
+                event->process_name, event->remaining_time);
+            }
+            break;
+        case PROCSIM_EVENT_FINISHED:
+            printf("%d,FINISHED,process_name=%s,proc_remaining=%d\n",
+            event->time, event->process_name, event->proc_remaining);
+            break;
+        case PROCSIM_EVENT_FINISHED_PROCESS:
+            printf("%d,FINISHED-PROCESS,process_name=%s,sha=%s\n",
+            event->time, event->process_name, event->sha256_digest);
+            break;
+        case PROCSIM_EVENT_USAGE:
+            if (!options->report_usage) {
+                break;
+            }
+            printf("%d,USAGE,process_name=%s,service_time=%u,user_us=%ld,sys_us=%ld,voluntary_switches=%ld,"
+            "involuntary_switches=%ld,max_rss_kb=%ld", event->time, event->process_name, event->service_time,
+            usage->user_time_us, usage->system_time_us, usage->voluntary_switches, usage->involuntary_switches,
+            usage->max_rss_kb);
+            // Only print the counters that could be opened
+            if (usage->cycles >= 0) {
+                printf(",cycles=%lld", usage->cycles);
+            }
+            if (usage->instructions >= 0) {
+                printf(",instructions=%lld", usage->instructions);
+            }
+            if (usage->task_clock_ns >= 0) {
+                printf(",task_clock_ns=%lld", usage->task_clock_ns);
+            }
+            printf("\n");
+            break;
     }
 }
 
 /*
-    * Move the processes that have been submitted to the system to the input queue.
-    * 
-    * @param processes The array of processes
-    * @param process_count The number of processes
-    * @param input_queue The input queue
-    * @param current_index The current index of the processes array
-    * @param current_time The current time
+    * Append a simulation event to the binary trace.
+    *
+    * @param file The binary trace
+    * @param event The event
+    * @param report_quantum Whether RUNNING events carry the length of the slice
     */
-void move_process_to_input_queue(Process *processes, int process_count, Node **input_queue, int *current_index, int current_time) {
-    int i;
-    for (i = *current_index; i < process_count; i++) {
-        if (processes[i].time_arrived <= current_time) {
-            enqueue(input_queue, &processes[i]);
-        } else {
+void write_binary_event(FILE *file, const procsim_event_t *event, bool report_quantum) {
+    trace_record_t record = {0};
+
+    record.time = event->time;
+    strncpy(record.process_name, event->process_name, PROCSIM_MAX_NAME_LENGTH);
+    switch (event->type) {
+        case PROCSIM_EVENT_READY:
+            record.type = TRACE_READY;
+            record.value = event->assigned_at;
             break;
-        }
+        case PROCSIM_EVENT_RUNNING:
+            record.type = TRACE_RUNNING;
+            record.value = event->remaining_time;
+            record.extra = report_quantum ? event->quantum : 0;
+            break;
+        case PROCSIM_EVENT_FINISHED:
+            record.type = TRACE_FINISHED;
+            record.value = event->proc_remaining;
+            break;
+        case PROCSIM_EVENT_FINISHED_PROCESS:
+            record.type = TRACE_FINISHED_PROCESS;
+            break;
+        default:
+            // Resource usage is not part of the schedule
+            return;
     }
-    // Update the current index
-    *current_index = i;
+    write_trace_record(file, &record);
 }
 
 /*
-    * Move the processes that successfully allocated memory to the ready queue.
-    * 
-    * @param input_queue The input queue
-    * @param ready_queue The ready queue
-    * @param memory_strategy The memory allocation strategy
-    * @param memory The head of the memory block list
+    * Prints the header of the memory statistics time series.
+    *
+    * @param file The output file
+    */
+void print_mem_stats_header(FILE *file) {
+    fprintf(file, "time,used,free_holes,largest_hole,external_fragmentation,admission_failures\n");
+}
+
+/*
+    * Prints one sample of the memory statistics time series.
+    *
+    * @param file The output file
+    * @param stats The memory statistics
     * @param current_time The current time
     */
-void move_process_to_ready_queue(Node **input_queue, Node **ready_queue, MemoryStrategy memory_strategy, mem_block_t **memory, int current_time) {
-    Node *temp = *input_queue;
-    while (temp) {
-        Process *process = temp->process;
-        if (process->time_arrived <= current_time) {
-            if (memory_strategy == BEST_FIT) {
-                mem_block_t *allocated_memory = best_fit_alloc(*memory, process, current_time);
-                if (allocated_memory) {
-                    enqueue(ready_queue, process);
-                    dequeue(input_queue);
-                } else {
-                    // No memory available
-                    break;
-                }
-            } else {
-                enqueue(ready_queue, process);
-                dequeue(input_queue);
-            }
-        } else {
-            // No process is ready
-            break;
-        }
-        temp = *input_queue;
-    }
+void print_mem_stats(FILE *file, const procsim_mem_stats_t *stats, int current_time) {
+    fprintf(file, "%d,%u,%u,%u,%.4f,%lu\n", current_time, stats->used, stats->free_holes,
+    stats->largest_hole, stats->external_fragmentation, stats->admission_failures);
 }
 
 /*
@@ -191,8 +339,9 @@ void move_process_to_ready_queue(Node **input_queue, Node **ready_queue, MemoryS
     * @param max_time_overhead The maximum time overhead
     * @param total_time_overhead The total time overhead
     * @param current_time The current time
+    * @param binary_trace The binary trace to append the statistics to, or NULL
 */
-void print_statistics(int process_count, double total_turnaround_time, double max_time_overhead, double total_time_overhead, int current_time) {
+void print_statistics(int process_count, double total_turnaround_time, double max_time_overhead, double total_time_overhead, int current_time, FILE *binary_trace) {
     max_time_overhead = round(max_time_overhead * 100) / 100;
     int average_turnaround_time = (int)(ceil(total_turnaround_time / process_count));
     double average_time_overhead = total_time_overhead / process_count;
@@ -202,6 +351,22 @@ void print_statistics(int process_count, double total_turnaround_time, double ma
     printf("Turnaround time %d\n", average_turnaround_time);
     printf("Time overhead %.2f %.2f\n", max_time_overhead, average_time_overhead);
     printf("Makespan %d\n", current_time);
+
+    // Record the same rounded values in the binary trace, time overheads in hundredths
+    if (binary_trace) {
+        trace_record_t record = {0};
+        record.type = TRACE_TURNAROUND;
+        record.value = average_turnaround_time;
+        write_trace_record(binary_trace, &record);
+        record.type = TRACE_OVERHEAD;
+        record.value = (int32_t) round(max_time_overhead * 100);
+        record.extra = (int32_t) round(average_time_overhead * 100);
+        write_trace_record(binary_trace, &record);
+        record.type = TRACE_MAKESPAN;
+        record.value = current_time;
+        record.extra = 0;
+        write_trace_record(binary_trace, &record);
+    }
 }
 
 /*
@@ -213,77 +378,169 @@ void print_statistics(int process_count, double total_turnaround_time, double ma
 */
 int main(int argc, char *argv[]) {
     char *filename = NULL;
-    Scheduler scheduler;
-    MemoryStrategy memory_strategy;
-    int quantum;
-    Process *processes = NULL;
-    int process_count = 0;
-    int process_count_finished = 0;
-    Node *input_queue = NULL;
-    Node *ready_queue = NULL;
-    int current_time = 0;
-    int current_index = 0;
-    mem_block_t *memory = NULL;
-    Process *current_running_process = NULL;
-    double total_turnaround_time = 0;
-    double max_time_overhead = 0;
-    double total_time_overhead = 0;
+    // Negative values mark options that were not given, so a resumed run can override only those that were
+    procsim_config_t config = {
+        .scheduler = (procsim_scheduler_t) -1,
+        .memory_strategy = (procsim_memory_strategy_t) -1,
+        .quantum = -1,
+        .process_path = "./process"
+    };
+    procsim_config_t current_config;
+    char *checkpoint_file = NULL;
+    int checkpoint_interval = DEFAULT_CHECKPOINT_INTERVAL;
+    char *resume_file = NULL;
+    int next_checkpoint = 0;
+    char *mem_stats_file = NULL;
+    int mem_stats_interval = 1;
+    FILE *mem_stats_output = NULL;
+    int next_sample = 0;
+    char *binary_trace_file = NULL;
+    print_options_t print_options = {false, false, NULL};
+    procsim_t *simulation = NULL;
+    procsim_stats_t stats;
+    procsim_mem_stats_t mem_stats;
 
     // Read the command line arguments
-    read_arguments(argc, argv, &filename, &scheduler, &memory_strategy, &quantum);
+    read_arguments(argc, argv, &filename, &config, &checkpoint_file, &checkpoint_interval, &resume_file,
+    &mem_stats_file, &mem_stats_interval, &print_options.report_usage, &binary_trace_file);
 
-    // Read the input file
-    read_input_file(filename, &processes, &process_count);
-    process_count_finished = process_count;
-
-    // Initialize the memory for best fit
-    if (memory_strategy == BEST_FIT) {
-        memory = init_mem(MAX_MEMORY_SIZE);
+    // Check if the adaptive quantum has a preemptive scheduler to drive
+    if (config.adaptive_target > 0 && (int) config.scheduler != -1 && config.scheduler != PROCSIM_RR) {
+        fprintf(stderr, "Adaptive quantum requires the RR scheduler\n");
+        exit(EXIT_FAILURE);
+    }
+    // Check if the longest slice belongs to an adaptive quantum and is not shorter than the base quantum
+    if (config.max_quantum > 0 && config.adaptive_target <= 0) {
+        fprintf(stderr, "Maximum quantum requires the adaptive quantum\n");
+        exit(EXIT_FAILURE);
+    }
+    if (config.max_quantum > 0 && config.quantum != -1 && config.max_quantum < config.quantum) {
+        fprintf(stderr, "Maximum quantum must be at least the quantum\n");
+        exit(EXIT_FAILURE);
     }
 
-    // Start the simulation
-    while (!is_empty(ready_queue) || current_running_process != NULL || process_count_finished != 0) {
-        // check if the current running process has finished
-        if (current_running_process != NULL && current_running_process->remaining_time <= 0) {
-            double turnaround_time = current_time - current_running_process->time_arrived;
-            double time_overhead = turnaround_time / current_running_process->service_time;
-            if (time_overhead > max_time_overhead) {
-                max_time_overhead = time_overhead;
+    if (resume_file) {
+        // Restore the simulation from the snapshot
+        simulation = procsim_load(resume_file);
+        if (!simulation) {
+            fprintf(stderr, "Error loading checkpoint: %s\n", resume_file);
+            exit(EXIT_FAILURE);
+        }
+        procsim_get_config(simulation, &current_config);
+        if ((int) config.memory_strategy != -1 && config.memory_strategy != current_config.memory_strategy) {
+            fprintf(stderr, "Memory strategy cannot be changed when resuming\n");
+            exit(EXIT_FAILURE);
+        }
+        if (config.memory_size != 0 && config.memory_size != current_config.memory_size) {
+            fprintf(stderr, "Memory size cannot be changed when resuming\n");
+            exit(EXIT_FAILURE);
+        }
+        // The scheduler and quantum may be overridden to branch a what-if run from the snapshot
+        if ((int) config.scheduler != -1 || config.quantum != -1 || config.adaptive_target > 0) {
+            if ((int) config.scheduler != -1) {
+                current_config.scheduler = config.scheduler;
             }
-            total_time_overhead += time_overhead;
-            total_turnaround_time += turnaround_time;
-            // Terminate the process and free the memory
-            handle_finished_process(current_running_process, current_time, &ready_queue, &input_queue, &memory, memory_strategy);
-            current_running_process = NULL;
-            // Count the number of finished processes
-            process_count_finished -= 1;
-            if (process_count_finished == 0) {
-                break;
+            if (config.quantum != -1) {
+                current_config.quantum = config.quantum;
             }
+            if (config.adaptive_target > 0) {
+                current_config.adaptive_target = config.adaptive_target;
+                current_config.max_quantum = config.max_quantum;
+                current_config.time_unit_ms = config.time_unit_ms;
+            }
+            if (!procsim_set_scheduler(simulation, &current_config)) {
+                fprintf(stderr, "Invalid scheduler for the checkpoint\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+    } else {
+        simulation = procsim_create(&config);
+        if (!simulation) {
+            fprintf(stderr, "Invalid simulator configuration\n");
+            exit(EXIT_FAILURE);
+        }
+
+        // Read the input file
+        read_input_file(filename, simulation);
+    }
+
+    procsim_get_config(simulation, &current_config);
+    print_options.report_quantum = current_config.adaptive_target > 0;
+    procsim_set_event_callback(simulation, print_event, &print_options);
+
+    if (binary_trace_file) {
+        // A resumed run starts a new trace, like the text log it mirrors
+        print_options.binary_trace = fopen(binary_trace_file, "wb");
+        if (!print_options.binary_trace || !write_trace_header(print_options.binary_trace)) {
+            fprintf(stderr, "Error opening file: %s\n", binary_trace_file);
+            exit(EXIT_FAILURE);
+        }
+    }
+    next_checkpoint = procsim_current_time(simulation) + checkpoint_interval;
+
+    if (mem_stats_file) {
+        // Check if there is a finite memory to sample
+        if (current_config.memory_strategy == PROCSIM_INFINITE) {
+            fprintf(stderr, "Memory statistics require a finite memory strategy\n");
+            exit(EXIT_FAILURE);
+        }
+        mem_stats_output = fopen(mem_stats_file, "w");
+        if (!mem_stats_output) {
+            fprintf(stderr, "Error opening file: %s\n", mem_stats_file);
+            exit(EXIT_FAILURE);
         }
+        print_mem_stats_header(mem_stats_output);
+        next_sample = procsim_current_time(simulation);
+    }
 
-        // Move the processes that have been submitted to the system to the input queue
-        move_process_to_input_queue(processes, process_count, &input_queue, &current_index, current_time);
+    // Start the simulation
+    while (!procsim_is_finished(simulation)) {
+        int current_time = procsim_current_time(simulation);
 
-        // Move the processes that successfully allocated memory to the ready queue
-        move_process_to_ready_queue(&input_queue, &ready_queue, memory_strategy, &memory, current_time);
+        // Save a snapshot once the checkpoint interval has elapsed
+        if (checkpoint_file && current_time >= next_checkpoint) {
+            // Flush the events first so the log never lags behind the snapshot
+            fflush(stdout);
+            if (print_options.binary_trace) {
+                fflush(print_options.binary_trace);
+            }
+            if (!procsim_save(simulation, checkpoint_file)) {
+                fprintf(stderr, "Error saving checkpoint: %s\n", checkpoint_file);
+            }
+            next_checkpoint = current_time + checkpoint_interval;
+        }
 
-        // Run the scheduler
-        if (scheduler == SJF) {
-            current_running_process = shortest_job_first(&ready_queue, &current_time, quantum, current_running_process);
-        } else {
-            current_running_process = round_robin(&ready_queue, &current_time, quantum, current_running_process);
+        // Sample the memory statistics once the sampling interval has elapsed
+        if (mem_stats_output && current_time >= next_sample) {
+            procsim_get_mem_stats(simulation, &mem_stats);
+            print_mem_stats(mem_stats_output, &mem_stats, current_time);
+            next_sample = current_time + mem_stats_interval;
         }
 
-        // Update the current time
-        current_time += quantum;
+        if (procsim_step(simulation) < 0) {
+            fprintf(stderr, "Error: The process did not start or respond correctly.\n");
+            procsim_destroy(simulation);
+            exit(1);
+        }
     }
 
     // Print the statistics of the simulation
-    print_statistics(process_count, total_turnaround_time, max_time_overhead, total_time_overhead, current_time);
+    procsim_get_stats(simulation, &stats);
+    print_statistics(stats.process_count, stats.total_turnaround_time, stats.max_time_overhead,
+    stats.total_time_overhead, stats.current_time, print_options.binary_trace);
+
+    if (print_options.binary_trace) {
+        fclose(print_options.binary_trace);
+    }
+
+    // Record the final state of memory
+    if (mem_stats_output) {
+        procsim_get_mem_stats(simulation, &mem_stats);
+        print_mem_stats(mem_stats_output, &mem_stats, stats.current_time);
+        fclose(mem_stats_output);
+    }
 
     // Free the memory
-    free_mem(memory);
-    free(processes);
+    procsim_destroy(simulation);
     return 0;
-}
\ No newline at end of file
+}
@@ -5,30 +5,32 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <getopt.h>
+#include <limits.h>
 #include <math.h>
-#include "simulated_process.h"
-#include "scheduler.h"
-#include "memory.h"
-#include "real_process.h"
+#include "procsim.h"
+#include "trace_format.h"
 
-// Two types of scheduling algorithms
-typedef enum {
-    SJF,
-    RR
-} Scheduler;
+// Simulation time between snapshots when -c is given without -i
+#define DEFAULT_CHECKPOINT_INTERVAL 1000
 
-// Two types of memory allocation strategies
-typedef enum {
-    INFINITE,
-    BEST_FIT
-} MemoryStrategy;
+// Optional parts of the event output
+typedef struct {
+    bool report_quantum;
+    bool report_usage;
+    // Compact binary copy of the events, NULL when not requested
+    FILE *binary_trace;
+} print_options_t;
 
 // Process manager functions
-void read_arguments(int argc, char *argv[], char **filename, Scheduler *scheduler, MemoryStrategy *memory_strategy, int *quantum);
-void read_input_file(char *filename, Process **processes, int *process_count);
-void handle_finished_process(Process *current_running_process, int current_time, Node **ready_queue, Node **input_queue, mem_block_t **memory, MemoryStrategy memory_strategy);
-void move_process_to_input_queue(Process *processes, int process_count, Node **input_queue, int *current_index, int current_time);
-void move_process_to_ready_queue(Node **input_queue, Node **ready_queue, MemoryStrategy memory_strategy, mem_block_t **memory, int current_time);
-void print_statistics(int process_count, double total_turnaround_time, double max_time_overhead, double total_time_overhead, int current_time);
+void read_arguments(int argc, char *argv[], char **filename, procsim_config_t *config,
+char **checkpoint_file, int *checkpoint_interval, char **resume_file, char **mem_stats_file, int *mem_stats_interval,
+bool *report_usage, char **binary_trace_file);
+void read_input_file(char *filename, procsim_t *simulation);
+void print_event(const procsim_event_t *event, void *user_data);
+void print_mem_stats_header(FILE *file);
+void print_mem_stats(FILE *file, const procsim_mem_stats_t *stats, int current_time);
+void write_binary_event(FILE *file, const procsim_event_t *event, bool report_quantum);
+void print_statistics(int process_count, double total_turnaround_time, double max_time_overhead, double total_time_overhead, int current_time, FILE *binary_trace);
 
 #endif // PROCESS_MANAGER_H
\ No newline at end of file
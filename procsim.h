@@ -0,0 +1,150 @@
+#ifndef PROCSIM_H
+#define PROCSIM_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Only the functions marked with PROCSIM_API are exported, the engine is built with hidden visibility
+#if defined(__GNUC__)
+#define PROCSIM_API __attribute__((visibility("default")))
+#else
+#define PROCSIM_API
+#endif
+
+// Longest job name accepted by procsim_add_job
+#define PROCSIM_MAX_NAME_LENGTH 8
+
+// Opaque simulator handle, every simulator owns all of its state
+typedef struct procsim procsim_t;
+
+// Scheduling algorithms
+typedef enum {
+    PROCSIM_SJF,
+    PROCSIM_RR
+} procsim_scheduler_t;
+
+// Memory allocation strategies
+typedef enum {
+    PROCSIM_INFINITE,
+    PROCSIM_BEST_FIT,
+    PROCSIM_BITMAP
+} procsim_memory_strategy_t;
+
+// Simulator configuration
+typedef struct {
+    procsim_scheduler_t scheduler;
+    procsim_memory_strategy_t memory_strategy;
+    // Quantum, or the base quantum when the adaptive quantum is enabled
+    int quantum;
+    // Size of the simulated memory, 0 for the default
+    unsigned int memory_size;
+    // Switch overhead target in percent for the adaptive RR quantum, 0 to disable it
+    double adaptive_target;
+    // Real duration of one unit of simulation time in milliseconds, 0 for the default
+    double time_unit_ms;
+    // Count cycles and instructions of the real processes with perf events
+    bool perf_counters;
+    // Real process started for every job, NULL to simulate without child processes
+    const char *process_path;
+    // Longest slice the adaptive quantum may choose, at least quantum, 0 for four times quantum
+    int max_quantum;
+} procsim_config_t;
+
+// Resources consumed by a real process, collected when it terminates
+typedef struct {
+    long user_time_us;
+    long system_time_us;
+    long voluntary_switches;
+    long involuntary_switches;
+    long max_rss_kb;
+    // Hardware counters, -1 when unavailable
+    long long cycles;
+    long long instructions;
+    // Software counter used when the hardware counters are unavailable, -1 otherwise
+    long long task_clock_ns;
+} procsim_usage_t;
+
+// Types of simulation events
+typedef enum {
+    PROCSIM_EVENT_READY,
+    PROCSIM_EVENT_RUNNING,
+    PROCSIM_EVENT_FINISHED,
+    PROCSIM_EVENT_FINISHED_PROCESS,
+    PROCSIM_EVENT_USAGE
+} procsim_event_type_t;
+
+// Simulation event, only the fields of the given type are meaningful
+typedef struct {
+    procsim_event_type_t type;
+    int time;
+    const char *process_name;
+    // READY: start of the memory assigned to the process
+    unsigned int assigned_at;
+    // RUNNING: remaining service time and length of the slice
+    int remaining_time;
+    int quantum;
+    // FINISHED: number of processes still waiting
+    int proc_remaining;
+    // FINISHED-PROCESS: digest reported by the real process
+    const char *sha256_digest;
+    // USAGE: simulated service time and resources consumed by the real process
+    unsigned int service_time;
+    const procsim_usage_t *usage;
+} procsim_event_t;
+
+// Event callback, called synchronously from the stepping functions
+typedef void (*procsim_event_cb)(const procsim_event_t *event, void *user_data);
+
+// Running statistics
+typedef struct {
+    int process_count;
+    int processes_finished;
+    double total_turnaround_time;
+    double max_time_overhead;
+    double total_time_overhead;
+    int current_time;
+} procsim_stats_t;
+
+// Memory statistics, only available for finite memory strategies
+typedef struct {
+    unsigned int total;
+    unsigned int used;
+    unsigned int free_holes;
+    unsigned int largest_hole;
+    double external_fragmentation;
+    unsigned long admission_failures;
+} procsim_mem_stats_t;
+
+// Simulator lifecycle
+PROCSIM_API procsim_t *procsim_create(const procsim_config_t *config);
+PROCSIM_API procsim_t *procsim_load(const char *filename);
+PROCSIM_API bool procsim_save(procsim_t *simulation, const char *filename);
+PROCSIM_API void procsim_destroy(procsim_t *simulation);
+
+// Jobs, events and policy. procsim_add_job returns -1 for a job that is out of order by arrival time,
+// has a name longer than PROCSIM_MAX_NAME_LENGTH or needs more than the memory size of a finite memory
+PROCSIM_API int procsim_add_job(procsim_t *simulation, unsigned int time_arrived, const char *process_name, unsigned int service_time, unsigned int memory_requirement);
+PROCSIM_API void procsim_set_event_callback(procsim_t *simulation, procsim_event_cb callback, void *user_data);
+PROCSIM_API bool procsim_set_scheduler(procsim_t *simulation, const procsim_config_t *config);
+PROCSIM_API void procsim_get_config(const procsim_t *simulation, procsim_config_t *config);
+
+// Stepping, 1 while there is more to simulate, 0 once every job has finished,
+// -1 once a real process could not be started or stopped responding
+PROCSIM_API int procsim_step(procsim_t *simulation);
+PROCSIM_API int procsim_run_until(procsim_t *simulation, int time);
+PROCSIM_API int procsim_run(procsim_t *simulation);
+PROCSIM_API bool procsim_is_finished(const procsim_t *simulation);
+PROCSIM_API int procsim_current_time(const procsim_t *simulation);
+
+// Statistics
+PROCSIM_API void procsim_get_stats(const procsim_t *simulation, procsim_stats_t *stats);
+PROCSIM_API bool procsim_get_mem_stats(const procsim_t *simulation, procsim_mem_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROCSIM_H
@@ -1,15 +1,98 @@
+// pipe2 is a GNU extension
+#define _GNU_SOURCE
 #include "real_process.h"
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/*
+    * Open a counter for the given process.
+    *
+    * @param process_id The process ID of the process to count
+    * @param type The perf event type
+    * @param config The perf event within the type
+    * @return The counter file descriptor, or -1 if the counter is unavailable
+*/
+static int open_counter(pid_t process_id, uint32_t type, uint64_t config) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    // Count user space only, which is allowed for unprivileged users
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, process_id, -1, -1, PERF_FLAG_FD_CLOEXEC);
+#else
+    return -1;
+#endif
+}
+
+/*
+    * Open the cycle and instruction counters for the process, falling back to the task clock.
+    *
+    * @param process The process to count
+*/
+static void open_perf_counters(Process *process) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        process->perf_fd[i] = -1;
+    }
+    if (!process->collect_perf) {
+        return;
+    }
+#ifdef __linux__
+    process->perf_fd[0] = open_counter(process->pid, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    process->perf_fd[1] = open_counter(process->pid, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    // Virtual machines often have no hardware counters
+    if (process->perf_fd[0] < 0 && process->perf_fd[1] < 0) {
+        process->perf_fd[2] = open_counter(process->pid, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+    }
+#endif
+}
+
+/*
+    * Read and close a counter.
+    *
+    * @param fd The counter file descriptor
+    * @return The counter value, or -1 if the counter is unavailable
+*/
+static long long read_counter(int fd) {
+    uint64_t value;
+
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t bytes = read(fd, &value, sizeof(value));
+    close(fd);
+    return bytes == sizeof(value) ? (long long) value : -1;
+}
 
 /*
     * Send the simulation time to the process.
     * 
     * @param pipe_fd The pipe file descriptor
     * @param simulation_time The simulation time
+    * @return True if the time was sent, false if the process has gone away
 */
-void send_simulation_time(int pipe_fd, uint32_t simulation_time) {
+bool send_simulation_time(int pipe_fd, uint32_t simulation_time) {
     // convert the simulation time to big endian
     uint32_t big_endian_time = htonl(simulation_time);
-    write(pipe_fd, &big_endian_time, sizeof(big_endian_time));
+    sigset_t pipe_signal, old_mask;
+    struct timespec no_wait = {0, 0};
+
+    // A dead child must not kill the host with SIGPIPE, so the write fails with EPIPE instead
+    sigemptyset(&pipe_signal);
+    sigaddset(&pipe_signal, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_signal, &old_mask);
+    ssize_t written = write(pipe_fd, &big_endian_time, sizeof(big_endian_time));
+    if (written < 0 && errno == EPIPE && !sigismember(&old_mask, SIGPIPE)) {
+        // Discard the signal raised by the write before it is unblocked
+        sigtimedwait(&pipe_signal, NULL, &no_wait);
+    }
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+    return written == sizeof(big_endian_time);
 }
 
 /*
@@ -21,119 +104,213 @@ void send_simulation_time(int pipe_fd, uint32_t simulation_time) {
 */
 uint8_t read_and_verify_byte(int pipe_fd, uint32_t simulation_time) {
     uint8_t byte_received;
-    read(pipe_fd, &byte_received, sizeof(byte_received));
+    if (read(pipe_fd, &byte_received, sizeof(byte_received)) != sizeof(byte_received)) {
+        return 0;
+    }
     return byte_received == (simulation_time & 0xFF);
 }
 
 /*
-    * Create a process and return its process ID.
+    * Create a process and store its process ID in the process.
+    * Without a process path the process is only marked as started, with a process ID of -1.
     * 
-    * @param process_name The name of the process
+    * @param process The process to create, its pipes and counters are filled in
+    * @param process_path The path to the real process binary, or NULL
     * @param verbose Whether to run the process in verbose mode
-    * @param to_child_pipe The pipe to write to the child process
-    * @param from_child_pipe The pipe to read from the child process
     * @param simulation_time The simulation time
-    * @return The process ID of the child process
+    * @return True if the process started and answered the handshake, false otherwise
 */
-pid_t create_process(const char *process_name, bool verbose, int *to_child_pipe, int *from_child_pipe, uint32_t simulation_time) {
+bool create_process(Process *process, const char *process_path, bool verbose, uint32_t simulation_time) {
     int pipe_in[2], pipe_out[2];
 
-    // Create the pipes
-    if (pipe(pipe_in) == -1 || pipe(pipe_out) == -1) {
-        perror("pipe");
-        return -1;
+    process->pid = -1;
+    if (!process_path) {
+        return true;
+    }
+
+    // Create the pipes closed on exec, atomically so concurrent simulators do not leak them into each other's children
+    if (pipe2(pipe_in, O_CLOEXEC) == -1) {
+        return false;
+    }
+    if (pipe2(pipe_out, O_CLOEXEC) == -1) {
+        close(pipe_in[0]);
+        close(pipe_in[1]);
+        return false;
     }
 
     pid_t pid = fork();
 
     if (pid == 0) { 
         // Child process
-        close(pipe_in[1]);
-        close(pipe_out[0]);
         dup2(pipe_in[0], STDIN_FILENO);
         dup2(pipe_out[1], STDOUT_FILENO);
 
         // Run the process
-        execl("./process", "process", verbose ? "-v" : NULL, process_name, NULL);
-        perror("execl");
-        _exit(1);
-    } else if (pid > 0) { 
-        // Parent process
-        close(pipe_in[0]);
-        close(pipe_out[1]);
-        *to_child_pipe = pipe_in[1];
-        *from_child_pipe = pipe_out[0];
-        send_simulation_time(*to_child_pipe, simulation_time);
-        // Verify that the process started correctly
-        if (!read_and_verify_byte(*from_child_pipe, simulation_time)) {
-            fprintf(stderr, "Error: The process did not start correctly.\n");
-            exit(1);
-        }
-        return pid;
-    } else {
-        perror("fork");
-        return -1;
+        execl(process_path, "process", verbose ? "-v" : NULL, process->process_name, NULL);
+        _exit(127);
+    }
+
+    close(pipe_in[0]);
+    close(pipe_out[1]);
+    if (pid < 0) {
+        close(pipe_in[1]);
+        close(pipe_out[0]);
+        return false;
     }
+
+    // Parent process
+    process->pipe_fd[1] = pipe_in[1];
+    process->pipe_fd[0] = pipe_out[0];
+    // Start counting before the process is given any work
+    process->pid = pid;
+    open_perf_counters(process);
+    // Verify that the process started correctly, a failed exec closes the pipe instead of answering
+    if (!send_simulation_time(process->pipe_fd[1], simulation_time) ||
+    !read_and_verify_byte(process->pipe_fd[0], simulation_time)) {
+        kill_process(process);
+        return false;
+    }
+    return true;
 }
 
 /*
     * Suspend the process and wait for it to be resumed.
     * 
-    * @param process_id The process ID of the process
+    * @param process_id The process ID of the process, negative if there is no real process
     * @param pipe_fd The pipe file descriptor
     * @param simulation_time The simulation time
+    * @return True if the process stopped, false if it has gone away
 */
-void suspend_process(pid_t process_id, int pipe_fd, uint32_t simulation_time) {
-    send_simulation_time(pipe_fd, simulation_time);
+bool suspend_process(pid_t process_id, int pipe_fd, uint32_t simulation_time) {
+    int wstatus;
+
+    if (process_id < 0) {
+        return true;
+    }
+    if (!send_simulation_time(pipe_fd, simulation_time)) {
+        return false;
+    }
     kill(process_id, SIGTSTP);
 
-    int wstatus;
     // Wait for the process to be stopped
-    waitpid(process_id, &wstatus, WUNTRACED);
-    while (!WIFSTOPPED(wstatus)) {
-        waitpid(process_id, &wstatus, WUNTRACED);
-    }
+    do {
+        if (waitpid(process_id, &wstatus, WUNTRACED) != process_id) {
+            return false;
+        }
+    } while (!WIFSTOPPED(wstatus));
+    return true;
 }
 
 /*
     * Resume the process and verify that the correct byte is received.
     * 
-    * @param process_id The process ID of the process
+    * @param process_id The process ID of the process, negative if there is no real process
     * @param pipe_fd The pipe file descriptor
     * @param simulation_time The simulation time
     * @param from_child_pipe The pipe to read from the child process
+    * @return True if the process answered with the correct byte, false otherwise
 */
-void resume_process(pid_t process_id, int pipe_fd, uint32_t simulation_time, int from_child_pipe) {
-    send_simulation_time(pipe_fd, simulation_time);
+bool resume_process(pid_t process_id, int pipe_fd, uint32_t simulation_time, int from_child_pipe) {
+    if (process_id < 0) {
+        return true;
+    }
+    if (!send_simulation_time(pipe_fd, simulation_time)) {
+        return false;
+    }
     kill(process_id, SIGCONT);
 
     // Verify that the correct byte is received
-    uint8_t received_byte = read_and_verify_byte(from_child_pipe, simulation_time);
-    if (!received_byte) {
-        fprintf(stderr, "Mismatched byte received from process %d\n", process_id);
-    }
+    return read_and_verify_byte(from_child_pipe, simulation_time);
 }
 
 /*
     * Terminate the process and wait for it to terminate.
     * 
-    * @param process_id The process ID of the process
+    * @param process_id The process ID of the process, negative if there is no real process
     * @param pipe_fd The pipe file descriptor
     * @param simulation_time The simulation time
     * @param from_child_pipe The pipe to read from the child process
     * @param current_running_process The process that is currently running
+    * @return True if the process reported its digest, false otherwise
 */
-void terminate_process(pid_t process_id, int pipe_fd, uint32_t simulation_time, int from_child_pipe, Process *current_running_process) {
+bool terminate_process(pid_t process_id, int pipe_fd, uint32_t simulation_time, int from_child_pipe, Process *current_running_process) {
     char sha256[65];
+    size_t received = 0;
 
-    send_simulation_time(pipe_fd, simulation_time);
+    if (process_id < 0) {
+        current_running_process->sha256_digest[0] = '\0';
+        return true;
+    }
+    bool ok = send_simulation_time(pipe_fd, simulation_time);
 
     // Terminate the child process
     kill(process_id, SIGTERM);
 
     // Read the SHA256 digest from the child process
-    read(from_child_pipe, sha256, 64);
-    sha256[64] = '\0';
+    while (ok && received < 64) {
+        ssize_t bytes = read(from_child_pipe, sha256 + received, 64 - received);
+        if (bytes <= 0) {
+            ok = false;
+        } else {
+            received += bytes;
+        }
+    }
+    sha256[received] = '\0';
 
     strcpy(current_running_process->sha256_digest, sha256);
-}
\ No newline at end of file
+
+    // Reap the child and collect the resources it consumed
+    collect_usage(process_id, current_running_process);
+    close(pipe_fd);
+    close(from_child_pipe);
+    return ok;
+}
+
+/*
+    * Wait for the process to exit and record its resource usage and counters.
+    * 
+    * @param process_id The process ID of the process
+    * @param process The process to record the usage for
+*/
+void collect_usage(pid_t process_id, Process *process) {
+    procsim_usage_t *usage = &process->usage;
+    struct rusage rusage;
+    int wstatus;
+
+    memset(usage, 0, sizeof(*usage));
+    if (wait4(process_id, &wstatus, 0, &rusage) == process_id) {
+        usage->user_time_us = rusage.ru_utime.tv_sec * 1000000L + rusage.ru_utime.tv_usec;
+        usage->system_time_us = rusage.ru_stime.tv_sec * 1000000L + rusage.ru_stime.tv_usec;
+        usage->voluntary_switches = rusage.ru_nvcsw;
+        usage->involuntary_switches = rusage.ru_nivcsw;
+        usage->max_rss_kb = rusage.ru_maxrss;
+    }
+
+    // The counters keep their final values after the process has exited
+    usage->cycles = read_counter(process->perf_fd[0]);
+    usage->instructions = read_counter(process->perf_fd[1]);
+    usage->task_clock_ns = read_counter(process->perf_fd[2]);
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        process->perf_fd[i] = -1;
+    }
+}
+/*
+    * Kill a process that is no longer needed and release its pipes and counters.
+    * 
+    * @param process The process, its process ID is reset to 0
+*/
+void kill_process(Process *process) {
+    if (process->pid > 0) {
+        kill(process->pid, SIGKILL);
+        waitpid(process->pid, NULL, 0);
+        close(process->pipe_fd[0]);
+        close(process->pipe_fd[1]);
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            if (process->perf_fd[i] >= 0) {
+                close(process->perf_fd[i]);
+            }
+            process->perf_fd[i] = -1;
+        }
+    }
+    process->pid = 0;
+}
@@ -6,17 +6,34 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/resource.h>
 #include <signal.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
 #include <arpa/inet.h>
 #include <stdbool.h>
 #include "simulated_process.h"
 
+// Real process backend, a NULL path simulates without child processes
+typedef struct {
+    const char *process_path;
+    // Set once a child could not be created or stopped responding
+    bool failed;
+    // Number of children created, so spawns can be told apart from context switches
+    unsigned long spawn_count;
+    // Real time spent suspending and continuing children, reset by the caller before each slice
+    double switch_time_ns;
+} process_backend_t;
+
 // Function prototypes for real process
-void send_simulation_time(int pipe_fd, uint32_t simulation_time);
+bool send_simulation_time(int pipe_fd, uint32_t simulation_time);
 uint8_t read_and_verify_byte(int pipe_fd, uint32_t simulation_time);
-pid_t create_process(const char *process_name, bool verbose, int *to_child_pipe, int *from_child_pipe, uint32_t simulation_time);
-void suspend_process(pid_t process_id, int pipe_fd, uint32_t simulation_time);
-void resume_process(pid_t process_id, int pipe_fd, uint32_t simulation_time, int from_child_pipe);
-void terminate_process(pid_t process_id, int pipe_fd, uint32_t simulation_time, int from_child_pipe, Process *current_running_process);
+bool create_process(Process *process, const char *process_path, bool verbose, uint32_t simulation_time);
+bool suspend_process(pid_t process_id, int pipe_fd, uint32_t simulation_time);
+bool resume_process(pid_t process_id, int pipe_fd, uint32_t simulation_time, int from_child_pipe);
+bool terminate_process(pid_t process_id, int pipe_fd, uint32_t simulation_time, int from_child_pipe, Process *current_running_process);
+void collect_usage(pid_t process_id, Process *process);
+void kill_process(Process *process);
 
 #endif // REAL_PROCESS_H
@@ -1,5 +1,52 @@
 #include "scheduler.h"
 
+/*
+    * Get the time elapsed since a start time in nanoseconds.
+    *
+    * @param start The start time
+    * @return The nanoseconds elapsed since start
+    */
+static double elapsed_ns(const struct timespec *start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec);
+}
+
+/*
+    * Suspend a process, adding the time the suspension took to the switch time of the backend.
+    *
+    * @param process The process to suspend
+    * @param current_time The current time
+    * @param backend The real process backend, marked as failed if the process stops responding
+    */
+static void timed_suspend(Process *process, int current_time, process_backend_t *backend) {
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!suspend_process(process->pid, process->pipe_fd[1], current_time)) {
+        backend->failed = true;
+    }
+    backend->switch_time_ns += elapsed_ns(&start);
+}
+
+/*
+    * Continue a process, adding the time the handshake took to the switch time of the backend.
+    *
+    * @param process The process to continue
+    * @param current_time The current time
+    * @param backend The real process backend, marked as failed if the process stops responding
+    */
+static void timed_resume(Process *process, int current_time, process_backend_t *backend) {
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!resume_process(process->pid, process->pipe_fd[1], current_time, process->pipe_fd[0])) {
+        backend->failed = true;
+    }
+    backend->switch_time_ns += elapsed_ns(&start);
+}
+
 /*
     * Simulate the shortest job first scheduling algorithm.
     * 
@@ -7,9 +54,11 @@
     * @param current_time The current time
     * @param quantum The quantum
     * @param current_running_process The current running process
+    * @param backend The real process backend, marked as failed if a process stops responding
+    * @param events The sink for the running event
     * @return The current running process
     */
-Process *shortest_job_first(Node **ready_queue, int *current_time, int quantum, Process *current_running_process) {
+Process *shortest_job_first(Node **ready_queue, int *current_time, int quantum, Process *current_running_process, process_backend_t *backend, const event_sink_t *events) {
     if (current_running_process == NULL) {
         // do nothing if the ready queue is empty
         if (is_empty(*ready_queue)) {
@@ -43,18 +92,18 @@ Process *shortest_job_first(Node **ready_queue, int *current_time, int quantum,
 
             // create a new process for the shortest process
             current_running_process = shortest_process;
-            current_running_process->pid = create_process(current_running_process->process_name, true,
-            &current_running_process->pipe_fd[1], &current_running_process->pipe_fd[0], *current_time);
-            // print the running process
-            printf("%d,RUNNING,process_name=%s,remaining_time=%d\n", *current_time,
-            current_running_process->process_name, current_running_process->remaining_time);
+            backend->spawn_count++;
+            if (!create_process(current_running_process, backend->process_path, true, *current_time)) {
+                backend->failed = true;
+            }
+            // report the running process
+            emit_running(events, *current_time, current_running_process, quantum);
             current_running_process->remaining_time -= quantum;
             return current_running_process;
         } 
     } 
     // continue running the current process
-    resume_process(current_running_process->pid, current_running_process->pipe_fd[1],
-    *current_time, current_running_process->pipe_fd[0]);
+    timed_resume(current_running_process, *current_time, backend);
     current_running_process->remaining_time -= quantum;
     return current_running_process;
 }
@@ -66,9 +115,11 @@ Process *shortest_job_first(Node **ready_queue, int *current_time, int quantum,
     * @param current_time The current time
     * @param quantum The quantum
     * @param current_running_process The current running process
+    * @param backend The real process backend, marked as failed if a process stops responding
+    * @param events The sink for the running event
     * @return The current running process
     */
-Process *round_robin(Node **ready_queue, int *current_time, int quantum, Process *current_running_process) {
+Process *round_robin(Node **ready_queue, int *current_time, int quantum, Process *current_running_process, process_backend_t *backend, const event_sink_t *events) {
     if (current_running_process == NULL) {
         // do nothing if the ready queue is empty
         if (is_empty(*ready_queue)) {
@@ -77,12 +128,11 @@ Process *round_robin(Node **ready_queue, int *current_time, int quantum, Process
     } else {
         if (!is_empty(*ready_queue)) {
             // suspend the current running process and put it back to the ready queue
-            suspend_process(current_running_process->pid, current_running_process->pipe_fd[1], *current_time);
+            timed_suspend(current_running_process, *current_time, backend);
             enqueue(ready_queue, current_running_process);
         } else {
             // continue running the current process
-            resume_process(current_running_process->pid, current_running_process->pipe_fd[1],
-            *current_time, current_running_process->pipe_fd[0]);
+            timed_resume(current_running_process, *current_time, backend);
             current_running_process->remaining_time -= quantum;
             return current_running_process;
         }
@@ -91,17 +141,17 @@ Process *round_robin(Node **ready_queue, int *current_time, int quantum, Process
     current_running_process = dequeue(ready_queue);
     if (current_running_process->pid == 0) {
         // create a new process for the next process in the ready queue
-        current_running_process->pid = create_process(current_running_process->process_name, true,
-        &current_running_process->pipe_fd[1], &current_running_process->pipe_fd[0], *current_time);
+        backend->spawn_count++;
+        if (!create_process(current_running_process, backend->process_path, true, *current_time)) {
+            backend->failed = true;
+        }
     } else {
         // continue running the next process in the ready queue
-        resume_process(current_running_process->pid, current_running_process->pipe_fd[1],
-        *current_time, current_running_process->pipe_fd[0]);
+        timed_resume(current_running_process, *current_time, backend);
     }
 
-    // print the running process
-    printf("%d,RUNNING,process_name=%s,remaining_time=%d\n", *current_time,
-    current_running_process->process_name, current_running_process->remaining_time);
+    // report the running process
+    emit_running(events, *current_time, current_running_process, quantum);
     current_running_process->remaining_time -= quantum;
     return current_running_process;
 }
\ No newline at end of file
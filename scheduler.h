@@ -1,11 +1,13 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
+#include <time.h>
 #include "simulated_process.h"
 #include "real_process.h"
+#include "events.h"
 
 // Scheduler functions
-Process *shortest_job_first(Node **ready_queue, int *current_time, int quantum, Process *current_running_process);
-Process *round_robin(Node **ready_queue, int *current_time, int quantum, Process *current_running_process);
+Process *shortest_job_first(Node **ready_queue, int *current_time, int quantum, Process *current_running_process, process_backend_t *backend, const event_sink_t *events);
+Process *round_robin(Node **ready_queue, int *current_time, int quantum, Process *current_running_process, process_backend_t *backend, const event_sink_t *events);
 
 #endif // SCHEDULER_H
\ No newline at end of file
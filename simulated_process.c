@@ -22,6 +22,59 @@ void enqueue(Node **head, Process *process) {
     }
 }
 
+/*
+    * Enqueue a contiguous run of processes to the end of the queue, walking the queue only once
+    *
+    * @param head The head of the queue
+    * @param processes The first process of the run
+    * @param count The number of processes in the run
+    */
+void enqueue_batch(Node **head, Process *processes, int count) {
+    Node **tail = head;
+
+    // Find the end of the queue
+    while (*tail != NULL) {
+        tail = &(*tail)->next;
+    }
+
+    for (int i = 0; i < count; i++) {
+        Node *new_node = (Node *)malloc(sizeof(Node));
+        new_node->process = &processes[i];
+        new_node->next = NULL;
+        *tail = new_node;
+        tail = &new_node->next;
+    }
+}
+
+/*
+    * Move the first nodes of one queue to the end of another without reallocating them
+    *
+    * @param from The head of the queue to take the nodes from
+    * @param to The head of the queue to append the nodes to
+    * @param count The number of nodes to move
+    */
+void splice_queue(Node **from, Node **to, int count) {
+    if (count <= 0 || *from == NULL) {
+        return;
+    }
+
+    // Cut the run off the front of the source queue
+    Node *first = *from;
+    Node *last = first;
+    for (int i = 1; i < count && last->next != NULL; i++) {
+        last = last->next;
+    }
+    *from = last->next;
+    last->next = NULL;
+
+    // Find the end of the destination queue
+    Node **tail = to;
+    while (*tail != NULL) {
+        tail = &(*tail)->next;
+    }
+    *tail = first;
+}
+
 /*
     * Dequeue a process from the front of the queue
     *
@@ -5,7 +5,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include "procsim.h"
 #define MAX_PROCESS_NAME_LENGTH 8
+#define PERF_COUNTER_COUNT 3
 
 // Simulated process structure
 typedef struct {
@@ -18,6 +20,9 @@ typedef struct {
     int pipe_fd[2];
     pid_t pid;
     char sha256_digest[65];
+    bool collect_perf;
+    int perf_fd[PERF_COUNTER_COUNT];
+    procsim_usage_t usage;
 } Process;
 
 // Simulated process queue
@@ -28,6 +33,8 @@ typedef struct Node {
 
 // Function prototypes for simulated process queue
 void enqueue(Node **head, Process *process);
+void enqueue_batch(Node **head, Process *processes, int count);
+void splice_queue(Node **from, Node **to, int count);
 Process *dequeue(Node **head);
 bool is_empty(Node *head);
 int count_process(Node *head);
@@ -0,0 +1,580 @@
+#include "simulation.h"
+#include "checkpoint.h"
+
+/*
+    * Allocate an empty simulation.
+    *
+    * @return The simulation with every field zeroed
+    */
+static Simulation *alloc_simulation(void) {
+    return (Simulation *) calloc(1, sizeof(Simulation));
+}
+
+/*
+    * Check whether a configuration can be simulated.
+    *
+    * @param config The configuration
+    * @return True if the configuration is valid, false otherwise
+    */
+bool valid_config(const procsim_config_t *config) {
+    if (config->scheduler != PROCSIM_SJF && config->scheduler != PROCSIM_RR) {
+        return false;
+    }
+    if (config->memory_strategy != PROCSIM_INFINITE && config->memory_strategy != PROCSIM_BEST_FIT &&
+    config->memory_strategy != PROCSIM_BITMAP) {
+        return false;
+    }
+    // The adaptive quantum only applies to the preemptive scheduler
+    if (config->adaptive_target < 0 || config->adaptive_target > 100 ||
+    (config->adaptive_target > 0 && config->scheduler != PROCSIM_RR)) {
+        return false;
+    }
+    // The longest adaptive slice may not be shorter than the base quantum
+    if (config->max_quantum != 0 && config->max_quantum < config->quantum) {
+        return false;
+    }
+    return config->quantum >= 1 && config->time_unit_ms >= 0;
+}
+
+/*
+    * Apply the scheduling part of the configuration.
+    *
+    * @param simulation The simulation
+    */
+static void apply_scheduler(Simulation *simulation) {
+    procsim_config_t *config = &simulation->config;
+
+    if (config->time_unit_ms == 0) {
+        config->time_unit_ms = DEFAULT_TIME_UNIT_MS;
+    }
+    simulation->quantum = config->quantum;
+    if (config->adaptive_target > 0) {
+        // The configured quantum becomes the base slice the controller scales with the ready queue
+        init_adaptive_quantum(&simulation->adaptive_quantum, config->adaptive_target, config->time_unit_ms,
+        config->quantum, config->max_quantum);
+    }
+}
+
+/*
+    * Initialize the memory of the configured strategy and its statistics.
+    *
+    * @param simulation The simulation
+    * @return True if the memory was allocated, false otherwise
+    */
+static bool init_memory(Simulation *simulation) {
+    unsigned int size = simulation->config.memory_size;
+
+    if (simulation->config.memory_strategy == PROCSIM_BEST_FIT) {
+        simulation->memory = init_mem(size);
+        if (!simulation->memory) {
+            return false;
+        }
+        init_mem_stats(&simulation->mem_stats, size);
+        collect_mem_stats(simulation->memory, &simulation->mem_stats);
+    } else if (simulation->config.memory_strategy == PROCSIM_BITMAP) {
+        simulation->bitmap = init_bitmap_mem(size);
+        if (!simulation->bitmap) {
+            return false;
+        }
+        init_mem_stats(&simulation->mem_stats, size);
+        collect_bitmap_stats(simulation->bitmap, &simulation->mem_stats);
+    }
+    return true;
+}
+
+/*
+    * Set the real process binary, keeping a copy so the caller's string may go away.
+    *
+    * @param simulation The simulation
+    * @param process_path The path to the real process binary, or NULL
+    */
+void set_process_path(Simulation *simulation, const char *process_path) {
+    free(simulation->process_path);
+    simulation->process_path = process_path ? strdup(process_path) : NULL;
+    simulation->config.process_path = simulation->process_path;
+    simulation->backend.process_path = simulation->process_path;
+}
+
+/*
+    * Create a simulator with no jobs.
+    *
+    * @param config The configuration
+    * @return The simulator, or NULL if the configuration is invalid
+    */
+procsim_t *procsim_create(const procsim_config_t *config) {
+    if (!config || !valid_config(config)) {
+        return NULL;
+    }
+
+    Simulation *simulation = alloc_simulation();
+    if (!simulation) {
+        return NULL;
+    }
+    simulation->config = *config;
+    if (simulation->config.memory_size == 0) {
+        simulation->config.memory_size = DEFAULT_MEMORY_SIZE;
+    }
+    set_process_path(simulation, config->process_path);
+    apply_scheduler(simulation);
+    if (!init_memory(simulation)) {
+        procsim_destroy(simulation);
+        return NULL;
+    }
+    return simulation;
+}
+
+/*
+    * Restore a simulator from a snapshot written by procsim_save.
+    * The child processes that had started are recreated.
+    *
+    * @param filename The path to the snapshot file
+    * @return The simulator, or NULL if the snapshot could not be loaded or its processes restarted
+    */
+procsim_t *procsim_load(const char *filename) {
+    Simulation *simulation = alloc_simulation();
+
+    if (!simulation) {
+        return NULL;
+    }
+    if (!load_checkpoint(filename, simulation)) {
+        procsim_destroy(simulation);
+        return NULL;
+    }
+    simulation->process_capacity = simulation->process_count;
+    if (simulation->config.adaptive_target > 0) {
+        init_adaptive_quantum(&simulation->adaptive_quantum, simulation->config.adaptive_target,
+        simulation->config.time_unit_ms, simulation->config.quantum, simulation->config.max_quantum);
+    }
+    if (!respawn_processes(simulation)) {
+        procsim_destroy(simulation);
+        return NULL;
+    }
+    return simulation;
+}
+
+/*
+    * Save a snapshot of the simulator.
+    *
+    * @param simulation The simulator
+    * @param filename The path to the snapshot file
+    * @return True if the snapshot was saved, false otherwise
+    */
+bool procsim_save(procsim_t *simulation, const char *filename) {
+    return save_checkpoint(filename, simulation);
+}
+
+/*
+    * Free a queue without touching its processes.
+    *
+    * @param head The head of the queue
+    */
+static void free_queue(Node *head) {
+    while (head) {
+        Node *next = head->next;
+        free(head);
+        head = next;
+    }
+}
+
+/*
+    * Destroy a simulator and free all of its state.
+    *
+    * @param simulation The simulator
+    */
+void procsim_destroy(procsim_t *simulation) {
+    if (!simulation) {
+        return;
+    }
+    // Stop the children of the jobs that have not finished, a failed load may not have allocated them
+    for (int i = 0; simulation->processes && i < simulation->process_count; i++) {
+        kill_process(&simulation->processes[i]);
+    }
+    free_queue(simulation->input_queue);
+    free_queue(simulation->ready_queue);
+    free_mem_stats(&simulation->mem_stats);
+    free_mem(simulation->memory);
+    free_bitmap_mem(simulation->bitmap);
+    free(simulation->processes);
+    free(simulation->process_path);
+    free(simulation);
+}
+
+/*
+    * Grow the process array. The queues point into the array, so their pointers are moved across.
+    *
+    * @param simulation The simulator
+    */
+static void grow_processes(Simulation *simulation) {
+    int capacity = simulation->process_capacity ? simulation->process_capacity * 2 : INITIAL_PROCESS_CAPACITY;
+    Process *old_processes = simulation->processes;
+    Process *processes = (Process *) calloc(capacity, sizeof(Process));
+    Node *queues[2] = {simulation->input_queue, simulation->ready_queue};
+
+    if (simulation->process_count) {
+        memcpy(processes, old_processes, simulation->process_count * sizeof(Process));
+    }
+    for (int i = 0; i < 2; i++) {
+        for (Node *current = queues[i]; current; current = current->next) {
+            current->process = processes + (current->process - old_processes);
+        }
+    }
+    if (simulation->current_running_process) {
+        simulation->current_running_process = processes + (simulation->current_running_process - old_processes);
+    }
+
+    free(old_processes);
+    simulation->processes = processes;
+    simulation->process_capacity = capacity;
+}
+
+/*
+    * Submit a job. Jobs must be added in order of arrival time.
+    *
+    * @param simulation The simulator
+    * @param time_arrived The time the job arrives
+    * @param process_name The name of the job
+    * @param service_time The service time of the job
+    * @param memory_requirement The memory the job needs
+    * @return 0 if the job was added, -1 if it is invalid, out of order or larger than the memory
+    */
+int procsim_add_job(procsim_t *simulation, unsigned int time_arrived, const char *process_name, unsigned int service_time, unsigned int memory_requirement) {
+    // Check if the job keeps the processes sorted by arrival time
+    if (!process_name || strlen(process_name) > MAX_PROCESS_NAME_LENGTH ||
+    (simulation->process_count > 0 && time_arrived < simulation->processes[simulation->process_count - 1].time_arrived)) {
+        return -1;
+    }
+    // A job larger than the whole memory could never be admitted
+    if (simulation->config.memory_strategy != PROCSIM_INFINITE && memory_requirement > simulation->config.memory_size) {
+        return -1;
+    }
+    if (simulation->process_count == simulation->process_capacity) {
+        grow_processes(simulation);
+    }
+
+    Process *process = &simulation->processes[simulation->process_count];
+    memset(process, 0, sizeof(Process));
+    process->time_arrived = time_arrived;
+    strcpy(process->process_name, process_name);
+    process->service_time = service_time;
+    process->memory_requirement = memory_requirement;
+    process->collect_perf = simulation->config.perf_counters;
+    // Set the remaining time to the service time
+    process->remaining_time = service_time;
+
+    simulation->process_count++;
+    simulation->process_count_finished++;
+    return 0;
+}
+
+/*
+    * Register the callback that receives the simulation events.
+    *
+    * @param simulation The simulator
+    * @param callback The callback, NULL to discard events
+    * @param user_data The pointer passed back to the callback
+    */
+void procsim_set_event_callback(procsim_t *simulation, procsim_event_cb callback, void *user_data) {
+    simulation->events.callback = callback;
+    simulation->events.user_data = user_data;
+}
+
+/*
+    * Change the scheduler, quantum and adaptive quantum settings. The memory and process settings are ignored.
+    *
+    * @param simulation The simulator
+    * @param config The configuration to take the scheduling settings from
+    * @return True if the settings were applied, false if they are invalid
+    */
+bool procsim_set_scheduler(procsim_t *simulation, const procsim_config_t *config) {
+    procsim_config_t updated = simulation->config;
+
+    updated.scheduler = config->scheduler;
+    updated.quantum = config->quantum;
+    updated.adaptive_target = config->adaptive_target;
+    updated.max_quantum = config->max_quantum;
+    updated.time_unit_ms = config->time_unit_ms;
+    if (!valid_config(&updated)) {
+        return false;
+    }
+    simulation->config = updated;
+    apply_scheduler(simulation);
+    return true;
+}
+
+/*
+    * Get the configuration of the simulator.
+    *
+    * @param simulation The simulator
+    * @param config The configuration to fill in
+    */
+void procsim_get_config(const procsim_t *simulation, procsim_config_t *config) {
+    *config = simulation->config;
+}
+
+/*
+    * Terminate the finished process and free the memory.
+    *
+    * @param simulation The simulation
+    * @return True if the real process reported its digest, false otherwise
+*/
+bool handle_finished_process(Simulation *simulation) {
+    Process *current_running_process = simulation->current_running_process;
+    int current_time = simulation->current_time;
+
+    // Terminate the process
+    bool terminated = terminate_process(current_running_process->pid, current_running_process->pipe_fd[1],
+    current_time, current_running_process->pipe_fd[0], current_running_process);
+    // The child is gone, so a snapshot must not record the process as started
+    current_running_process->pid = 0;
+
+    int proc_remaining = count_process(simulation->ready_queue) + count_process(simulation->input_queue);
+    emit_finished(&simulation->events, current_time, current_running_process, proc_remaining);
+    // Only a real process has a digest and resource usage to report
+    if (simulation->process_path) {
+        emit_finished_process(&simulation->events, current_time, current_running_process);
+        emit_usage(&simulation->events, current_time, current_running_process);
+    }
+    if (simulation->config.memory_strategy == PROCSIM_BEST_FIT) {
+        // Free the memory
+        release_mem(simulation->memory, current_running_process, &simulation->mem_stats);
+    } else if (simulation->config.memory_strategy == PROCSIM_BITMAP) {
+        bitmap_release(simulation->bitmap, current_running_process, &simulation->mem_stats);
+    }
+    return terminated;
+}
+
+/*
+    * Move the processes that have been submitted to the system to the input queue.
+    * The processes are sorted by arrival time, so everything that has arrived is one contiguous run.
+    *
+    * @param simulation The simulation
+    */
+void move_process_to_input_queue(Simulation *simulation) {
+    int low = simulation->current_index;
+    int high = simulation->process_count;
+
+    // Binary search for the first process that has not arrived yet
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (simulation->processes[middle].time_arrived <= (unsigned int) simulation->current_time) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    enqueue_batch(&simulation->input_queue, &simulation->processes[simulation->current_index],
+    low - simulation->current_index);
+    // Update the current index
+    simulation->current_index = low;
+}
+
+/*
+    * Move the processes that successfully allocated memory to the ready queue.
+    * Every process in the input queue has already arrived, so the longest prefix that fits in memory
+    * is admitted with a single allocator pass and its nodes are spliced onto the ready queue.
+    *
+    * @param simulation The simulation
+    */
+void move_process_to_ready_queue(Simulation *simulation) {
+    procsim_memory_strategy_t memory_strategy = simulation->config.memory_strategy;
+    int admitted;
+
+    if (is_empty(simulation->input_queue)) {
+        return;
+    }
+
+    if (memory_strategy == PROCSIM_BEST_FIT) {
+        admitted = best_fit_alloc_batch(simulation->memory, simulation->input_queue, &simulation->mem_stats);
+    } else if (memory_strategy == PROCSIM_BITMAP) {
+        admitted = bitmap_alloc_batch(simulation->bitmap, simulation->input_queue, &simulation->mem_stats);
+    } else {
+        admitted = count_process(simulation->input_queue);
+    }
+
+    if (memory_strategy != PROCSIM_INFINITE) {
+        Node *node = simulation->input_queue;
+        for (int i = 0; i < admitted; i++, node = node->next) {
+            emit_ready(&simulation->events, simulation->current_time, node->process);
+        }
+        // No memory available for the rest
+        if (node) {
+            mem_stats_admission_failed(&simulation->mem_stats);
+        }
+    }
+
+    splice_queue(&simulation->input_queue, &simulation->ready_queue, admitted);
+}
+
+/*
+    * Run the scheduler for one slice.
+    *
+    * @param simulation The simulation
+    */
+static void run_scheduler(Simulation *simulation) {
+    if (simulation->config.scheduler == PROCSIM_SJF) {
+        simulation->current_running_process = shortest_job_first(&simulation->ready_queue, &simulation->current_time,
+        simulation->quantum, simulation->current_running_process, &simulation->backend, &simulation->events);
+    } else if (simulation->config.adaptive_target > 0) {
+        // Choose the slice from the measured switch cost and the ready queue depth
+        unsigned long spawn_count = simulation->backend.spawn_count;
+        simulation->quantum = next_quantum(&simulation->adaptive_quantum, count_process(simulation->ready_queue));
+        // The scheduler times only the suspend and continue calls, not the queue work or the event callback
+        simulation->backend.switch_time_ns = 0;
+        simulation->current_running_process = round_robin(&simulation->ready_queue, &simulation->current_time,
+        simulation->quantum, simulation->current_running_process, &simulation->backend, &simulation->events);
+        // A fork and exec or an idle slice would skew the average
+        if (simulation->current_running_process && simulation->backend.spawn_count == spawn_count) {
+            record_switch_cost(&simulation->adaptive_quantum, simulation->backend.switch_time_ns);
+        }
+    } else {
+        simulation->current_running_process = round_robin(&simulation->ready_queue, &simulation->current_time,
+        simulation->quantum, simulation->current_running_process, &simulation->backend, &simulation->events);
+    }
+}
+
+/*
+    * Advance the simulation by one slice.
+    *
+    * @param simulation The simulator
+    * @return 1 if there is more to simulate, 0 once every job has finished, -1 if a real process failed
+    */
+int procsim_step(procsim_t *simulation) {
+    if (simulation->backend.failed) {
+        return -1;
+    }
+    if (procsim_is_finished(simulation)) {
+        return 0;
+    }
+
+    Process *current_running_process = simulation->current_running_process;
+    // check if the current running process has finished
+    if (current_running_process != NULL && current_running_process->remaining_time <= 0) {
+        double turnaround_time = simulation->current_time - current_running_process->time_arrived;
+        double time_overhead = turnaround_time / current_running_process->service_time;
+        if (time_overhead > simulation->max_time_overhead) {
+            simulation->max_time_overhead = time_overhead;
+        }
+        simulation->total_time_overhead += time_overhead;
+        simulation->total_turnaround_time += turnaround_time;
+        // Terminate the process and free the memory
+        if (!handle_finished_process(simulation)) {
+            simulation->backend.failed = true;
+        }
+        simulation->current_running_process = NULL;
+        // Count the number of finished processes
+        simulation->process_count_finished -= 1;
+        if (simulation->backend.failed) {
+            return -1;
+        }
+        if (simulation->process_count_finished == 0) {
+            return 0;
+        }
+    }
+
+    // Move the processes that have been submitted to the system to the input queue
+    move_process_to_input_queue(simulation);
+
+    // Move the processes that successfully allocated memory to the ready queue
+    move_process_to_ready_queue(simulation);
+
+    // Run the scheduler
+    run_scheduler(simulation);
+    if (simulation->backend.failed) {
+        return -1;
+    }
+
+    // Update the current time
+    simulation->current_time += simulation->quantum;
+    return 1;
+}
+
+/*
+    * Advance the simulation until the given time is reached or every job has finished.
+    *
+    * @param simulation The simulator
+    * @param time The time to run to
+    * @return 1 if there is more to simulate, 0 once every job has finished, -1 if a real process failed
+    */
+int procsim_run_until(procsim_t *simulation, int time) {
+    int status = simulation->backend.failed ? -1 : 1;
+
+    while (status > 0 && simulation->current_time < time) {
+        status = procsim_step(simulation);
+    }
+    if (status < 0) {
+        return -1;
+    }
+    return procsim_is_finished(simulation) ? 0 : 1;
+}
+
+/*
+    * Advance the simulation until every job has finished.
+    *
+    * @param simulation The simulator
+    * @return 0 once every job has finished, -1 if a real process failed
+    */
+int procsim_run(procsim_t *simulation) {
+    int status;
+
+    while ((status = procsim_step(simulation)) > 0) {
+    }
+    return status;
+}
+
+/*
+    * Check whether every submitted job has finished.
+    *
+    * @param simulation The simulator
+    * @return True if no job is left, false otherwise
+    */
+bool procsim_is_finished(const procsim_t *simulation) {
+    return simulation->process_count_finished == 0;
+}
+
+/*
+    * Get the current simulation time.
+    *
+    * @param simulation The simulator
+    * @return The current time
+    */
+int procsim_current_time(const procsim_t *simulation) {
+    return simulation->current_time;
+}
+
+/*
+    * Get the running statistics of the simulation.
+    *
+    * @param simulation The simulator
+    * @param stats The statistics to fill in
+    */
+void procsim_get_stats(const procsim_t *simulation, procsim_stats_t *stats) {
+    stats->process_count = simulation->process_count;
+    stats->processes_finished = simulation->process_count - simulation->process_count_finished;
+    stats->total_turnaround_time = simulation->total_turnaround_time;
+    stats->max_time_overhead = simulation->max_time_overhead;
+    stats->total_time_overhead = simulation->total_time_overhead;
+    stats->current_time = simulation->current_time;
+}
+
+/*
+    * Get the memory statistics of the simulation.
+    *
+    * @param simulation The simulator
+    * @param stats The statistics to fill in
+    * @return True if the statistics were filled in, false if memory is infinite
+    */
+bool procsim_get_mem_stats(const procsim_t *simulation, procsim_mem_stats_t *stats) {
+    const mem_stats_t *mem_stats = &simulation->mem_stats;
+
+    if (simulation->config.memory_strategy == PROCSIM_INFINITE) {
+        return false;
+    }
+    stats->total = mem_stats->total;
+    stats->used = mem_stats->used;
+    stats->free_holes = mem_stats->free_holes;
+    stats->largest_hole = mem_stats->largest_hole;
+    stats->external_fragmentation = external_fragmentation(mem_stats);
+    stats->admission_failures = mem_stats->admission_failures;
+    return true;
+}
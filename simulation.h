@@ -0,0 +1,60 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "procsim.h"
+#include "simulated_process.h"
+#include "scheduler.h"
+#include "memory.h"
+#include "bitmap_memory.h"
+#include "mem_stats.h"
+#include "real_process.h"
+#include "adaptive_quantum.h"
+#include "events.h"
+
+#define DEFAULT_MEMORY_SIZE 2048
+#define DEFAULT_TIME_UNIT_MS 1000
+#define INITIAL_PROCESS_CAPACITY 16
+
+// Simulation state behind the procsim_t handle
+struct procsim {
+    procsim_config_t config;
+    // Length of the current slice, differs from config.quantum only with the adaptive quantum
+    int quantum;
+    Process *processes;
+    int process_count;
+    int process_capacity;
+    // Number of processes that have not finished yet
+    int process_count_finished;
+    Node *input_queue;
+    Node *ready_queue;
+    int current_time;
+    int current_index;
+    mem_block_t *memory;
+    bitmap_mem_t *bitmap;
+    mem_stats_t mem_stats;
+    Process *current_running_process;
+    double total_turnaround_time;
+    double max_time_overhead;
+    double total_time_overhead;
+    adaptive_quantum_t adaptive_quantum;
+    event_sink_t events;
+    // Copy of config.process_path owned by the simulation
+    char *process_path;
+    process_backend_t backend;
+};
+
+typedef struct procsim Simulation;
+
+// Simulation functions
+bool valid_config(const procsim_config_t *config);
+bool handle_finished_process(Simulation *simulation);
+void set_process_path(Simulation *simulation, const char *process_path);
+void move_process_to_input_queue(Simulation *simulation);
+void move_process_to_ready_queue(Simulation *simulation);
+
+#endif // SIMULATION_H
@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../memory.h"
+#include "../bitmap_memory.h"
+
+// Compares batched best fit admission against allocating each job in turn, for both allocators
+
+#define MEMORY_SIZE 2048
+// Large enough for the bitmap summary to span several words
+#define LARGE_MEMORY_SIZE 300000
+#define ROUND_COUNT 2000
+#define MAX_BURST 40
+// Largest job as a share of the memory, about a seventh
+#define REQUIREMENT_DIVISOR 7
+
+// One memory and the jobs placed in it
+typedef struct {
+    mem_block_t *memory;
+    bitmap_mem_t *bitmap;
+    mem_stats_t stats;
+    Process processes[MAX_BURST];
+    bool resident[MAX_BURST];
+} admission_t;
+
+/*
+    * Create an empty memory of the given allocator.
+    *
+    * @param admission The memory to initialize
+    * @param use_bitmap True for the bitmap allocator, false for the block list
+    * @param size The size of the memory
+    */
+static void init_admission(admission_t *admission, bool use_bitmap, unsigned int size) {
+    memset(admission, 0, sizeof(*admission));
+    init_mem_stats(&admission->stats, size);
+    if (use_bitmap) {
+        admission->bitmap = init_bitmap_mem(size);
+        collect_bitmap_stats(admission->bitmap, &admission->stats);
+    } else {
+        admission->memory = init_mem(size);
+        collect_mem_stats(admission->memory, &admission->stats);
+    }
+}
+
+/*
+    * Free a memory created by init_admission.
+    *
+    * @param admission The memory
+    */
+static void free_admission(admission_t *admission) {
+    free_mem(admission->memory);
+    free_bitmap_mem(admission->bitmap);
+    free_mem_stats(&admission->stats);
+}
+
+/*
+    * Compare the memory contents and statistics of the two memories.
+    *
+    * @param batched The memory admitted in batches
+    * @param per_job The memory admitted one job at a time
+    * @return True if the memories are the same, false otherwise
+    */
+static bool same_memory(const admission_t *batched, const admission_t *per_job) {
+    if (batched->bitmap) {
+        if (memcmp(batched->bitmap->words, per_job->bitmap->words, batched->bitmap->word_count * sizeof(uint64_t)) != 0) {
+            return false;
+        }
+    } else {
+        const mem_block_t *a = batched->memory, *b = per_job->memory;
+
+        for (; a && b; a = a->next, b = b->next) {
+            if (a->start != b->start || a->size != b->size || a->is_allocated != b->is_allocated) {
+                return false;
+            }
+        }
+        if (a || b) {
+            return false;
+        }
+    }
+    return batched->stats.used == per_job->stats.used && batched->stats.free_holes == per_job->stats.free_holes
+    && batched->stats.largest_hole == per_job->stats.largest_hole;
+}
+
+/*
+    * Compare the incrementally updated statistics with statistics collected from scratch.
+    *
+    * @param admission The memory
+    * @return True if the statistics match, false otherwise
+    */
+static bool stats_match_memory(const admission_t *admission) {
+    mem_stats_t collected;
+    bool match;
+
+    init_mem_stats(&collected, admission->stats.total);
+    if (admission->bitmap) {
+        collect_bitmap_stats(admission->bitmap, &collected);
+    } else {
+        collect_mem_stats(admission->memory, &collected);
+    }
+    match = collected.used == admission->stats.used && collected.free_holes == admission->stats.free_holes
+    && collected.largest_hole == admission->stats.largest_hole;
+    free_mem_stats(&collected);
+    return match;
+}
+
+/*
+    * Admit random same-tick bursts into both memories and release random jobs between them.
+    *
+    * @param use_bitmap True for the bitmap allocator, false for the block list
+    * @param size The size of the memory
+    * @return True if every round placed the jobs in the same places, false otherwise
+    */
+static bool compare_admission(bool use_bitmap, unsigned int size) {
+    static admission_t batched, per_job;
+    const char *allocator = use_bitmap ? "bitmap" : "best-fit";
+    bool same = true;
+
+    init_admission(&batched, use_bitmap, size);
+    init_admission(&per_job, use_bitmap, size);
+    srand(31);
+
+    for (int round = 0; round < ROUND_COUNT && same; round++) {
+        int burst = 1 + rand() % MAX_BURST;
+        Node *queue = NULL;
+        int admitted = 0;
+
+        // A burst of jobs arriving in the same tick, in slots that are not resident
+        for (int i = 0; i < MAX_BURST && burst > 0; i++) {
+            if (!batched.resident[i]) {
+                batched.processes[i].memory_requirement = 1 + rand() % (size / REQUIREMENT_DIVISOR);
+                per_job.processes[i].memory_requirement = batched.processes[i].memory_requirement;
+                enqueue(&queue, &batched.processes[i]);
+                burst--;
+            }
+        }
+
+        int batch_admitted = use_bitmap ? bitmap_alloc_batch(batched.bitmap, queue, &batched.stats) :
+        best_fit_alloc_batch(batched.memory, queue, &batched.stats);
+        for (Node *node = queue; node; node = node->next) {
+            Process *process = &per_job.processes[node->process - batched.processes];
+            bool allocated = use_bitmap ? bitmap_alloc(per_job.bitmap, process, &per_job.stats) :
+            best_fit_alloc(per_job.memory, process, &per_job.stats) != NULL;
+            if (!allocated) {
+                break;
+            }
+            admitted++;
+        }
+
+        if (batch_admitted != admitted) {
+            fprintf(stderr, "%s round %d: batch admitted %d jobs, per job %d\n", allocator, round, batch_admitted,
+            admitted);
+            same = false;
+        }
+        for (Node *node = queue; same && admitted > 0; node = node->next, admitted--) {
+            int slot = node->process - batched.processes;
+            if (batched.processes[slot].memory_start != per_job.processes[slot].memory_start) {
+                fprintf(stderr, "%s round %d: job in slot %d placed at %u, per job at %u\n", allocator, round, slot,
+                batched.processes[slot].memory_start, per_job.processes[slot].memory_start);
+                same = false;
+            }
+            batched.resident[slot] = true;
+        }
+        while (!is_empty(queue)) {
+            dequeue(&queue);
+        }
+
+        // Release about half of the resident jobs in both memories
+        for (int i = 0; i < MAX_BURST; i++) {
+            if (batched.resident[i] && rand() % 2) {
+                if (use_bitmap) {
+                    bitmap_release(batched.bitmap, &batched.processes[i], &batched.stats);
+                    bitmap_release(per_job.bitmap, &per_job.processes[i], &per_job.stats);
+                } else {
+                    release_mem(batched.memory, &batched.processes[i], &batched.stats);
+                    release_mem(per_job.memory, &per_job.processes[i], &per_job.stats);
+                }
+                batched.resident[i] = false;
+            }
+        }
+
+        if (same && !same_memory(&batched, &per_job)) {
+            fprintf(stderr, "%s round %d: memories differ\n", allocator, round);
+            same = false;
+        }
+        if (same && !stats_match_memory(&batched)) {
+            fprintf(stderr, "%s round %d: statistics differ from the memory\n", allocator, round);
+            same = false;
+        }
+    }
+
+    free_admission(&batched);
+    free_admission(&per_job);
+    return same;
+}
+
+int main(void) {
+    if (!compare_admission(false, MEMORY_SIZE) || !compare_admission(true, MEMORY_SIZE) ||
+    !compare_admission(true, LARGE_MEMORY_SIZE)) {
+        return 1;
+    }
+    printf("admission: %d rounds match for both allocators\n", ROUND_COUNT);
+    return 0;
+}
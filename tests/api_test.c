@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../procsim.h"
+
+// Checks the documented behavior of the libprocsim API, using only procsim.h
+
+#define MAX_EVENTS 4096
+#define EVENT_LENGTH 96
+#define JOB_COUNT 12
+
+// Events delivered to the callback, formatted like the allocate output
+typedef struct {
+    char events[MAX_EVENTS][EVENT_LENGTH];
+    int count;
+    int finished_process_count;
+} event_log_t;
+
+static int failures = 0;
+
+/*
+    * Report a failed check.
+    *
+    * @param condition The condition that should hold
+    * @param description What the condition checks
+    */
+static void check(int condition, const char *description) {
+    if (!condition) {
+        fprintf(stderr, "api: %s\n", description);
+        failures++;
+    }
+}
+
+/*
+    * Record an event in the log.
+    *
+    * @param event The event
+    * @param user_data The event log
+    */
+static void record_event(const procsim_event_t *event, void *user_data) {
+    event_log_t *log = (event_log_t *) user_data;
+
+    if (log->count == MAX_EVENTS) {
+        return;
+    }
+    char *line = log->events[log->count++];
+    switch (event->type) {
+        case PROCSIM_EVENT_READY:
+            snprintf(line, EVENT_LENGTH, "%d,READY,%s,%u", event->time, event->process_name, event->assigned_at);
+            break;
+        case PROCSIM_EVENT_RUNNING:
+            snprintf(line, EVENT_LENGTH, "%d,RUNNING,%s,%d", event->time, event->process_name, event->remaining_time);
+            break;
+        case PROCSIM_EVENT_FINISHED:
+            snprintf(line, EVENT_LENGTH, "%d,FINISHED,%s,%d", event->time, event->process_name, event->proc_remaining);
+            break;
+        default:
+            log->count--;
+            log->finished_process_count++;
+            break;
+    }
+}
+
+/*
+    * Create a simulator with the same jobs for every check.
+    *
+    * @param strategy The memory strategy
+    * @param process_path The real process, NULL to only simulate
+    * @param log The event log to deliver events to
+    * @return The simulator
+    */
+static procsim_t *create_simulation(procsim_memory_strategy_t strategy, const char *process_path, event_log_t *log) {
+    procsim_config_t config = {.scheduler = PROCSIM_RR, .memory_strategy = strategy, .quantum = 3};
+    config.process_path = process_path;
+    procsim_t *simulation = procsim_create(&config);
+
+    if (!simulation) {
+        return NULL;
+    }
+    memset(log, 0, sizeof(*log));
+    procsim_set_event_callback(simulation, record_event, log);
+    for (int i = 0; i < JOB_COUNT; i++) {
+        char name[PROCSIM_MAX_NAME_LENGTH + 1];
+        snprintf(name, sizeof(name), "J%d", i);
+        procsim_add_job(simulation, (unsigned int) (i / 3) * 4, name, 2 + (i * 7) % 11, 100 + (i * 131) % 700);
+    }
+    return simulation;
+}
+
+/*
+    * Check the jobs procsim_add_job rejects.
+    */
+static void check_add_job(void) {
+    procsim_config_t config = {.scheduler = PROCSIM_RR, .memory_strategy = PROCSIM_BEST_FIT, .quantum = 3};
+    procsim_t *simulation = procsim_create(&config);
+    procsim_mem_stats_t mem_stats;
+
+    check(procsim_add_job(simulation, 5, "A", 3, 10) == 0, "a valid job is accepted");
+    check(procsim_add_job(simulation, 4, "B", 3, 10) == -1, "a job out of order is rejected");
+    check(procsim_add_job(simulation, 5, "NINECHARS", 3, 10) == -1, "a name over 8 characters is rejected");
+    check(procsim_add_job(simulation, 6, "C", 3, 2049) == -1, "a job larger than the memory is rejected");
+    check(procsim_add_job(simulation, 6, "D", 3, 2048) == 0, "a job filling the memory is accepted");
+    check(procsim_get_mem_stats(simulation, &mem_stats) && mem_stats.total == 2048, "best-fit reports memory statistics");
+    procsim_destroy(simulation);
+
+    config.memory_strategy = PROCSIM_INFINITE;
+    simulation = procsim_create(&config);
+    check(procsim_add_job(simulation, 0, "E", 3, 5000) == 0, "infinite memory accepts any size");
+    check(!procsim_get_mem_stats(simulation, &mem_stats), "infinite memory has no memory statistics");
+    procsim_destroy(simulation);
+}
+
+/*
+    * Check stepping a pure simulation to the end.
+    *
+    * @param log The event log of the run, kept for the other checks
+    */
+static void check_run(event_log_t *log) {
+    procsim_t *simulation = create_simulation(PROCSIM_BEST_FIT, NULL, log);
+    procsim_stats_t stats;
+
+    check(procsim_run_until(simulation, 10) == 1, "run_until returns 1 while jobs remain");
+    check(procsim_current_time(simulation) >= 10 && !procsim_is_finished(simulation), "run_until stops at the given time");
+    check(procsim_run(simulation) == 0, "run returns 0 once every job has finished");
+    check(procsim_is_finished(simulation), "the simulation is finished");
+    check(procsim_step(simulation) == 0, "stepping a finished simulation returns 0");
+    procsim_get_stats(simulation, &stats);
+    check(stats.process_count == JOB_COUNT && stats.processes_finished == JOB_COUNT, "every job finished");
+    check(log->finished_process_count == 0, "no real process events without a process path");
+    procsim_destroy(simulation);
+}
+
+/*
+    * Check that a snapshot resumes with the same events as the uninterrupted run.
+    *
+    * @param full The event log of the uninterrupted run
+    */
+static void check_snapshot(const event_log_t *full) {
+    static event_log_t before, after;
+    procsim_t *simulation = create_simulation(PROCSIM_BEST_FIT, NULL, &before);
+    const char *filename = "api_test.ckpt";
+
+    procsim_run_until(simulation, 20);
+    check(procsim_save(simulation, filename), "the snapshot is saved");
+    procsim_destroy(simulation);
+
+    simulation = procsim_load(filename);
+    check(simulation != NULL, "the snapshot is loaded");
+    remove(filename);
+    if (!simulation) {
+        return;
+    }
+    memset(&after, 0, sizeof(after));
+    procsim_set_event_callback(simulation, record_event, &after);
+    check(procsim_run(simulation) == 0, "the resumed run finishes");
+    procsim_destroy(simulation);
+
+    int same = before.count + after.count == full->count;
+    for (int i = 0; same && i < before.count; i++) {
+        same = strcmp(before.events[i], full->events[i]) == 0;
+    }
+    for (int i = 0; same && i < after.count; i++) {
+        same = strcmp(after.events[i], full->events[before.count + i]) == 0;
+    }
+    check(same, "the events before and after the snapshot match the uninterrupted run");
+}
+
+/*
+    * Check that simulators stepped in turn do not affect each other.
+    *
+    * @param full The event log of a run on its own
+    */
+static void check_independent(const event_log_t *full) {
+    static event_log_t first, second;
+    procsim_t *a = create_simulation(PROCSIM_BEST_FIT, NULL, &first);
+    procsim_t *b = create_simulation(PROCSIM_BEST_FIT, NULL, &second);
+    int running_a = 1, running_b = 1;
+
+    while (running_a > 0 || running_b > 0) {
+        if (running_a > 0) {
+            running_a = procsim_step(a);
+        }
+        if (running_b > 0) {
+            running_b = procsim_step(b);
+        }
+    }
+    procsim_destroy(a);
+    procsim_destroy(b);
+    check(memcmp(first.events, full->events, sizeof(first.events)) == 0 && first.count == full->count
+    && memcmp(second.events, full->events, sizeof(second.events)) == 0 && second.count == full->count,
+    "interleaved simulators produce the events of a run on its own");
+}
+
+/*
+    * Check that a real process failure is reported instead of ending the host.
+    */
+static void check_process_failure(void) {
+    static event_log_t log;
+    procsim_t *simulation = create_simulation(PROCSIM_INFINITE, "./no-such-process", &log);
+
+    check(procsim_run(simulation) == -1, "a process that cannot be started is reported as -1");
+    procsim_destroy(simulation);
+}
+
+int main(void) {
+    static event_log_t full;
+
+    check_add_job();
+    check_run(&full);
+    check_snapshot(&full);
+    check_independent(&full);
+    check_process_failure();
+
+    if (failures) {
+        fprintf(stderr, "api: %d checks failed\n", failures);
+        return 1;
+    }
+    printf("api: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+
+// Stand-in for the real process used by the checks, it follows the same protocol
+// but reports a digest of its name, so every run of a schedule prints the same output
+
+#define DIGEST_LENGTH 64
+
+static volatile sig_atomic_t suspend_requested, continue_requested, terminate_requested;
+
+/*
+    * Record the signal, the main loop acts on it.
+    *
+    * @param signal_number The signal received
+    */
+static void handle_signal(int signal_number) {
+    if (signal_number == SIGTSTP) {
+        suspend_requested = 1;
+    } else if (signal_number == SIGCONT) {
+        continue_requested = 1;
+    } else {
+        terminate_requested = 1;
+    }
+}
+
+/*
+    * Read the 32 bit big endian simulation time sent by the manager.
+    *
+    * @return The least significant byte of the time
+    */
+static uint8_t read_time(void) {
+    uint8_t buffer[4];
+    size_t received = 0;
+
+    while (received < sizeof(buffer)) {
+        ssize_t count = read(STDIN_FILENO, buffer + received, sizeof(buffer) - received);
+        if (count <= 0) {
+            _exit(1);
+        }
+        received += count;
+    }
+    return buffer[3];
+}
+
+/*
+    * Write the least significant byte of the time back to the manager.
+    *
+    * @param byte The byte to write
+    */
+static void write_byte(uint8_t byte) {
+    if (write(STDOUT_FILENO, &byte, 1) != 1) {
+        _exit(1);
+    }
+}
+
+/*
+    * Write a digest derived from the process name.
+    *
+    * @param name The process name
+    */
+static void write_digest(const char *name) {
+    char digest[DIGEST_LENGTH];
+    unsigned int hash = 5381;
+
+    for (const char *c = name; *c; c++) {
+        hash = hash * 33 + (unsigned char) *c;
+    }
+    for (int i = 0; i < DIGEST_LENGTH; i++) {
+        digest[i] = "0123456789abcdef"[(hash >> (i % 8 * 4)) & 15];
+    }
+    if (write(STDOUT_FILENO, digest, DIGEST_LENGTH) != DIGEST_LENGTH) {
+        _exit(1);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    struct sigaction action;
+    sigset_t handled, unblocked;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s [-v] <process_name>\n", argv[0]);
+        return 1;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_signal;
+    sigaction(SIGTSTP, &action, NULL);
+    sigaction(SIGCONT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // Keep the signals blocked outside sigsuspend so none of them is missed
+    sigemptyset(&handled);
+    sigaddset(&handled, SIGTSTP);
+    sigaddset(&handled, SIGCONT);
+    sigaddset(&handled, SIGTERM);
+    sigprocmask(SIG_BLOCK, &handled, &unblocked);
+
+    write_byte(read_time());
+    while (1) {
+        while (!suspend_requested && !continue_requested && !terminate_requested) {
+            sigsuspend(&unblocked);
+        }
+        if (terminate_requested) {
+            read_time();
+            write_digest(argv[argc - 1]);
+            return 0;
+        }
+        if (suspend_requested) {
+            suspend_requested = 0;
+            read_time();
+            raise(SIGSTOP);
+        }
+        if (continue_requested) {
+            continue_requested = 0;
+            write_byte(read_time());
+        }
+    }
+}
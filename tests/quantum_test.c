@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../adaptive_quantum.h"
+
+// Checks how the adaptive quantum scales with the ready queue depth and where it is clamped
+
+// A 5 percent target of a 1 ms time unit leaves 50000 ns of switching per unit of slice
+#define TARGET_PERCENT 5
+#define TIME_UNIT_MS 1
+#define BASE_QUANTUM 2
+
+static int failures = 0;
+
+/*
+    * Compare the quantum chosen for a queue depth with the expected one.
+    *
+    * @param controller The adaptive quantum controller
+    * @param depth The ready queue depth
+    * @param expected The expected quantum
+    * @param description What the case checks
+    */
+static void expect_quantum(const adaptive_quantum_t *controller, int depth, int expected, const char *description) {
+    int quantum = next_quantum(controller, depth);
+
+    if (quantum != expected) {
+        fprintf(stderr, "%s: depth %d gave quantum %d, expected %d\n", description, depth, quantum, expected);
+        failures++;
+    }
+}
+
+int main(void) {
+    adaptive_quantum_t controller;
+
+    // Without a measured switch cost the slice only follows the queue depth
+    init_adaptive_quantum(&controller, TARGET_PERCENT, TIME_UNIT_MS, BASE_QUANTUM, 0);
+    expect_quantum(&controller, 0, BASE_QUANTUM * DEFAULT_MAX_QUANTUM_FACTOR, "empty queue uses the default maximum");
+    expect_quantum(&controller, REFERENCE_QUEUE_DEPTH, BASE_QUANTUM, "reference depth uses the base quantum");
+    expect_quantum(&controller, 2, 4, "shallower queue gets a longer slice");
+    expect_quantum(&controller, 8, 1, "deeper queue gets a shorter slice");
+    expect_quantum(&controller, 100, 1, "very deep queue is clamped to one unit");
+
+    // A configured maximum caps the scaled slice
+    init_adaptive_quantum(&controller, TARGET_PERCENT, TIME_UNIT_MS, BASE_QUANTUM, 5);
+    expect_quantum(&controller, 0, 5, "empty queue uses the configured maximum");
+    expect_quantum(&controller, 1, 5, "single waiting process is clamped to the maximum");
+
+    // 120000 ns per switch needs at least 3 units to stay under 50000 ns per unit
+    init_adaptive_quantum(&controller, TARGET_PERCENT, TIME_UNIT_MS, BASE_QUANTUM, 0);
+    record_switch_cost(&controller, 120000);
+    expect_quantum(&controller, 8, 3, "switch cost raises a short slice");
+    expect_quantum(&controller, REFERENCE_QUEUE_DEPTH, 3, "switch cost raises the base quantum");
+    expect_quantum(&controller, 1, 8, "switch cost leaves a longer slice alone");
+
+    // The newest measurement moves the average by its weight, 120000 - 0.2 * 100000
+    record_switch_cost(&controller, 20000);
+    expect_quantum(&controller, 8, 2, "cheaper switches lower the floor");
+
+    // A switch too expensive for any slice is clamped to the maximum
+    record_switch_cost(&controller, 1e12);
+    expect_quantum(&controller, 8, BASE_QUANTUM * DEFAULT_MAX_QUANTUM_FACTOR, "expensive switches are clamped");
+
+    if (failures > 0) {
+        return 1;
+    }
+    printf("quantum: scaling and clamping match\n");
+    return 0;
+}
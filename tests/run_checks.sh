@@ -0,0 +1,191 @@
+#!/bin/sh
+# Runs the checks against the built tools, use make check to build them first
+
+cd "$(dirname "$0")/.." || exit 1
+ROOT=$(pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+# allocate starts ./process, so every run happens in the work directory next to the stand-in
+cp tests/process "$WORK/process"
+failures=0
+
+pass() {
+    echo "PASS: $1"
+}
+
+fail() {
+    echo "FAIL: $1"
+    failures=$((failures + 1))
+}
+
+# Run allocate in the work directory
+allocate() {
+    (cd "$WORK" && "$ROOT/allocate" "$@")
+}
+
+# Batched admission places every job where admitting one job at a time would
+if tests/admission_test > /dev/null; then
+    pass "batched admission matches allocating each job in turn"
+else
+    fail "batched admission matches allocating each job in turn"
+fi
+
+# The adaptive quantum scales with the ready queue depth, never drops below the switch cost floor and stays within its bounds
+if tests/quantum_test > /dev/null; then
+    pass "adaptive quantum scaling and clamping"
+else
+    fail "adaptive quantum scaling and clamping"
+fi
+
+# Same-tick bursts, the expected outputs were produced by the per-job admission path
+for scheduler in SJF RR; do
+    for strategy in best-fit bitmap; do
+        name="burst_${scheduler}_${strategy}"
+        allocate -f "$ROOT/tests/inputs/burst.txt" -s "$scheduler" -m "$strategy" -q 3 \
+        --mem-stats "$name.csv" > "$WORK/$name.out"
+        if cmp -s "$WORK/$name.out" "tests/expected/$name.out" && cmp -s "$WORK/$name.csv" "tests/expected/$name.csv"; then
+            pass "$name matches the per-job admission output"
+        else
+            fail "$name matches the per-job admission output"
+        fi
+    done
+done
+
+# The library API, run in the work directory because it writes a snapshot there
+if (cd "$WORK" && "$ROOT/tests/api_test" > /dev/null); then
+    pass "libprocsim API"
+else
+    fail "libprocsim API"
+fi
+
+# A run resumed from its last snapshot prints the rest of the uninterrupted run
+allocate -f "$ROOT/tests/inputs/burst.txt" -s RR -m best-fit -q 3 -c run.ckpt -i 200 > "$WORK/full.out"
+if allocate --resume run.ckpt > "$WORK/resumed.out" && [ -s "$WORK/resumed.out" ] \
+&& tail -n "$(wc -l < "$WORK/resumed.out")" "$WORK/full.out" | cmp -s - "$WORK/resumed.out"; then
+    pass "checkpoint round trip"
+else
+    fail "checkpoint round trip"
+fi
+
+# A damaged snapshot fails to load instead of hanging or crashing,
+# the strategy, quantum, current quantum and next arrival are 32 bit integers after the 8 byte header
+damaged=0
+for field in "1 \\007" "2 \\000" "4 \\000" "8 \\377"; do
+    set -- $field
+    cp "$WORK/run.ckpt" "$WORK/damaged.ckpt"
+    printf "$2$2$2$2" | dd of="$WORK/damaged.ckpt" bs=1 seek=$((8 + 4 * $1)) conv=notrunc 2> /dev/null
+    allocate --resume damaged.ckpt > /dev/null 2>&1
+    # allocate reports a snapshot it cannot load with status 1, anything else is a crash or a run
+    if [ $? -ne 1 ]; then
+        damaged=1
+    fi
+done
+if [ "$damaged" -eq 0 ]; then
+    pass "damaged snapshots are rejected"
+else
+    fail "damaged snapshots are rejected"
+fi
+
+# Without -i snapshots are written at the default interval
+printf '0 long 1500 10\n' > "$WORK/long_job.txt"
+if allocate -f long_job.txt -s RR -m best-fit -q 3 -c default.ckpt > /dev/null && [ -s "$WORK/default.ckpt" ]; then
+    pass "checkpoint default interval"
+else
+    fail "checkpoint default interval"
+fi
+
+# Usage reporting adds one USAGE event per job with its service time and leaves the rest of the output alone
+allocate -f "$ROOT/tests/inputs/burst.txt" -s RR -m best-fit -q 3 --usage > "$WORK/usage.out"
+if grep -v ',USAGE,' "$WORK/usage.out" | cmp -s - "$WORK/full.out" \
+&& awk 'NR == FNR { service_time[$2] = $3; jobs++; next }
+    /,USAGE,/ {
+        split($0, fields, ",")
+        name = substr(fields[3], length("process_name=") + 1)
+        if (fields[4] == "service_time=" service_time[name] && fields[5] ~ /^user_us=[0-9]+$/) usage++
+    }
+    END { exit usage != jobs }' "tests/inputs/burst.txt" "$WORK/usage.out"; then
+    pass "usage reporting"
+else
+    fail "usage reporting"
+fi
+
+# A larger memory admits a job that does not fit the default one, with either allocator
+printf '0 big 10 1000000\n0 small 5 10\n' > "$WORK/big_job.txt"
+sized=0
+for strategy in best-fit bitmap; do
+    if ! allocate -f big_job.txt -s SJF -m "$strategy" -q 1 --memory-size 2000000 | grep -q ',FINISHED,process_name=big,' \
+    || allocate -f big_job.txt -s SJF -m "$strategy" -q 1 > /dev/null 2>&1; then
+        sized=1
+    fi
+done
+if [ "$sized" -eq 0 ] && ! allocate --resume run.ckpt --memory-size 4096 > /dev/null 2>&1; then
+    pass "memory size option"
+else
+    fail "memory size option"
+fi
+
+# Input lines are validated field by field, names may contain hyphens but numbers may not be negative
+printf '0 job-a 3 10\n1 job-b 2 20\n' > "$WORK/hyphen.txt"
+printf '0 job-a 3 10\n1 job-b 2 -20\n' > "$WORK/negative.txt"
+printf '0 ninechars 3 10\n' > "$WORK/long.txt"
+if allocate -f hyphen.txt -s RR -m best-fit -q 1 > /dev/null \
+&& ! allocate -f negative.txt -s RR -m best-fit -q 1 > /dev/null 2>&1 \
+&& ! allocate -f long.txt -s RR -m best-fit -q 1 > /dev/null 2>&1; then
+    pass "input file validation"
+else
+    fail "input file validation"
+fi
+
+# tracediff exits with the given status for the two traces
+tracediff_exits() {
+    expected=$1
+    shift
+    ./tracediff -q "$@" > /dev/null 2>&1
+    [ $? -eq "$expected" ]
+}
+
+# A binary trace holds the same records as the text output of its run, including adaptive slices
+for options in "-s SJF -m best-fit -q 3" "-s RR -m bitmap -q 2" "-s RR -m infinite -q 2 --adaptive-quantum 5 --time-unit-ms 1"; do
+    # The options are split into words on purpose
+    allocate -f "$ROOT/tests/inputs/burst.txt" $options --binary-trace trace.bin > "$WORK/trace.out"
+    if tracediff_exits 0 "$WORK/trace.out" "$WORK/trace.bin" && tracediff_exits 0 "$WORK/trace.bin" "$WORK/trace.out" \
+    && [ -s "$WORK/trace.bin" ]; then
+        pass "binary trace matches the text output ($options)"
+    else
+        fail "binary trace matches the text output ($options)"
+    fi
+done
+
+# Exit status 0 for matching traces, 1 for different ones and 2 for errors
+allocate -f "$ROOT/tests/inputs/burst.txt" -s RR -m best-fit -q 3 --binary-trace q3.bin > "$WORK/q3.out"
+allocate -f "$ROOT/tests/inputs/burst.txt" -s RR -m best-fit -q 1 > "$WORK/q1.out"
+printf 'PSTR\377\377\377\377' > "$WORK/bad.bin"
+if tracediff_exits 0 "$WORK/q3.out" "$WORK/q3.bin" && tracediff_exits 0 "$WORK/q3.bin" "$WORK/q3.bin" \
+&& tracediff_exits 0 "$WORK/q3.out" /dev/stdin < "$WORK/q3.bin"; then
+    pass "tracediff exits with 0 for matching traces"
+else
+    fail "tracediff exits with 0 for matching traces"
+fi
+if tracediff_exits 1 "$WORK/q3.out" "$WORK/q1.out" && tracediff_exits 1 "$WORK/q3.bin" "$WORK/q1.out"; then
+    pass "tracediff exits with 1 for different traces"
+else
+    fail "tracediff exits with 1 for different traces"
+fi
+if tracediff_exits 2 "$WORK/q3.out" "$WORK/missing.out" && tracediff_exits 2 "$WORK/bad.bin" "$WORK/q3.out" \
+&& tracediff_exits 2 "$WORK/q3.out" && tracediff_exits 2 -t -1 "$WORK/q3.out" "$WORK/q1.out"; then
+    pass "tracediff exits with 2 on errors"
+else
+    fail "tracediff exits with 2 on errors"
+fi
+# With -t only a regression beyond the tolerance fails, the quantum 1 run has the shorter makespan
+if tracediff_exits 0 -t 5 "$WORK/q3.out" "$WORK/q1.out" && tracediff_exits 1 -t 5 "$WORK/q1.out" "$WORK/q3.out"; then
+    pass "tracediff -t fails only on regressions"
+else
+    fail "tracediff -t fails only on regressions"
+fi
+
+if [ "$failures" -ne 0 ]; then
+    echo "$failures check(s) failed"
+    exit 1
+fi
+echo "All checks passed"
@@ -0,0 +1,273 @@
+#include "trace_format.h"
+
+// Size of a packed binary record: type, time, value, extra and process name
+#define TRACE_RECORD_SIZE (1 + 3 * sizeof(int32_t) + PROCSIM_MAX_NAME_LENGTH + 1)
+
+/*
+    * Write the header of a binary trace.
+    *
+    * @param file The trace file
+    * @return True if the header was written, false otherwise
+    */
+bool write_trace_header(FILE *file) {
+    uint32_t version = TRACE_VERSION;
+    return fwrite(TRACE_MAGIC, TRACE_MAGIC_LENGTH, 1, file) == 1 && fwrite(&version, sizeof(version), 1, file) == 1;
+}
+
+/*
+    * Append a record to a binary trace.
+    *
+    * @param file The trace file
+    * @param record The record to write
+    * @return True if the record was written, false otherwise
+    */
+bool write_trace_record(FILE *file, const trace_record_t *record) {
+    unsigned char buffer[TRACE_RECORD_SIZE];
+    unsigned char *position = buffer;
+
+    // Pack the fields so the record size does not depend on struct padding
+    *position++ = record->type;
+    memcpy(position, &record->time, sizeof(int32_t));
+    position += sizeof(int32_t);
+    memcpy(position, &record->value, sizeof(int32_t));
+    position += sizeof(int32_t);
+    memcpy(position, &record->extra, sizeof(int32_t));
+    position += sizeof(int32_t);
+    memcpy(position, record->process_name, PROCSIM_MAX_NAME_LENGTH + 1);
+    return fwrite(buffer, sizeof(buffer), 1, file) == 1;
+}
+
+/*
+    * Open a trace and detect whether it is text or binary.
+    *
+    * @param reader The reader to initialise
+    * @param filename The path to the trace
+    * @return True if the trace was opened, false otherwise
+    */
+bool open_trace(trace_reader_t *reader, const char *filename) {
+    char magic[TRACE_MAGIC_LENGTH];
+    uint32_t version;
+    int first;
+
+    memset(reader, 0, sizeof(*reader));
+    reader->file = fopen(filename, "rb");
+    if (!reader->file) {
+        return false;
+    }
+    // Large reads keep multi-gigabyte traces from being bound by system calls
+    setvbuf(reader->file, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+
+    // Peek a single byte so traces can also be read from pipes, text traces never start with the magic
+    first = getc(reader->file);
+    if (first != TRACE_MAGIC[0]) {
+        if (first != EOF) {
+            ungetc(first, reader->file);
+        }
+        return true;
+    }
+    magic[0] = (char) first;
+    if (fread(magic + 1, TRACE_MAGIC_LENGTH - 1, 1, reader->file) != 1
+    || memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_LENGTH) != 0
+    || fread(&version, sizeof(version), 1, reader->file) != 1 || version != TRACE_VERSION) {
+        // Not a trace, or one written by an incompatible version
+        fclose(reader->file);
+        reader->file = NULL;
+        return false;
+    }
+    reader->binary = true;
+    return true;
+}
+
+/*
+    * Read the next binary record.
+    *
+    * @param reader The reader
+    * @param record The record to read into
+    * @return True if a record was read, false at the end of the trace
+    */
+static bool read_binary_record(trace_reader_t *reader, trace_record_t *record) {
+    unsigned char buffer[TRACE_RECORD_SIZE];
+    unsigned char *position = buffer;
+
+    if (fread(buffer, sizeof(buffer), 1, reader->file) != 1) {
+        return false;
+    }
+    record->type = *position++;
+    memcpy(&record->time, position, sizeof(int32_t));
+    position += sizeof(int32_t);
+    memcpy(&record->value, position, sizeof(int32_t));
+    position += sizeof(int32_t);
+    memcpy(&record->extra, position, sizeof(int32_t));
+    position += sizeof(int32_t);
+    memcpy(record->process_name, position, PROCSIM_MAX_NAME_LENGTH + 1);
+    record->process_name[PROCSIM_MAX_NAME_LENGTH] = '\0';
+    reader->position++;
+    return true;
+}
+
+/*
+    * Read the next record of a trace, skipping text lines that are not part of the schedule.
+    *
+    * @param reader The reader
+    * @param record The record to read into
+    * @return True if a record was read, false at the end of the trace
+    */
+bool read_trace_record(trace_reader_t *reader, trace_record_t *record) {
+    if (reader->binary) {
+        return read_binary_record(reader, record);
+    }
+    while (getline(&reader->line, &reader->line_capacity, reader->file) != -1) {
+        reader->position++;
+        if (parse_trace_line(reader->line, record)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+    * Close a trace.
+    *
+    * @param reader The reader
+    */
+void close_trace(trace_reader_t *reader) {
+    if (reader->file) {
+        fclose(reader->file);
+    }
+    free(reader->line);
+    reader->file = NULL;
+    reader->line = NULL;
+}
+
+/*
+    * Read the integer value of a key=value field of an event line.
+    *
+    * @param line The event line
+    * @param key The key including the equals sign
+    * @param value The value to read into
+    * @return True if the field was found, false otherwise
+    */
+static bool read_field(const char *line, const char *key, int32_t *value) {
+    const char *field = strstr(line, key);
+
+    if (!field) {
+        return false;
+    }
+    *value = (int32_t) strtol(field + strlen(key), NULL, 10);
+    return true;
+}
+
+/*
+    * Parse one line of a text trace.
+    *
+    * @param line The line
+    * @param record The record to parse into
+    * @return True if the line is an event or statistic, false otherwise
+    */
+bool parse_trace_line(const char *line, trace_record_t *record) {
+    char *end;
+    const char *name;
+    size_t length;
+
+    memset(record, 0, sizeof(*record));
+
+    // Statistics lines printed at the end of the run
+    if (strncmp(line, "Turnaround time ", 16) == 0) {
+        record->type = TRACE_TURNAROUND;
+        record->value = (int32_t) strtol(line + 16, NULL, 10);
+        return true;
+    }
+    if (strncmp(line, "Time overhead ", 14) == 0) {
+        double max_time_overhead = strtod(line + 14, &end);
+        double average_time_overhead = strtod(end, NULL);
+        record->type = TRACE_OVERHEAD;
+        record->value = (int32_t) (max_time_overhead * 100 + 0.5);
+        record->extra = (int32_t) (average_time_overhead * 100 + 0.5);
+        return true;
+    }
+    if (strncmp(line, "Makespan ", 9) == 0) {
+        record->type = TRACE_MAKESPAN;
+        record->value = (int32_t) strtol(line + 9, NULL, 10);
+        return true;
+    }
+
+    // Event lines start with the time
+    record->time = (int32_t) strtol(line, &end, 10);
+    if (end == line || *end != ',') {
+        return false;
+    }
+    line = end + 1;
+    if (strncmp(line, "READY,", 6) == 0) {
+        record->type = TRACE_READY;
+        read_field(line, "assigned_at=", &record->value);
+    } else if (strncmp(line, "RUNNING,", 8) == 0) {
+        record->type = TRACE_RUNNING;
+        read_field(line, "remaining_time=", &record->value);
+        read_field(line, "quantum=", &record->extra);
+    } else if (strncmp(line, "FINISHED,", 9) == 0) {
+        record->type = TRACE_FINISHED;
+        read_field(line, "proc_remaining=", &record->value);
+    } else if (strncmp(line, "FINISHED-PROCESS,", 17) == 0) {
+        // The digest only verifies the real process, it is not part of the schedule
+        record->type = TRACE_FINISHED_PROCESS;
+    } else {
+        // USAGE differs between runs of the same schedule, so it is skipped like unknown lines
+        return false;
+    }
+
+    name = strstr(line, "process_name=");
+    if (!name) {
+        return false;
+    }
+    name += 13;
+    length = strcspn(name, ",\n");
+    if (length > PROCSIM_MAX_NAME_LENGTH) {
+        length = PROCSIM_MAX_NAME_LENGTH;
+    }
+    memcpy(record->process_name, name, length);
+    return true;
+}
+
+/*
+    * Format a record as the line allocate would print for it.
+    *
+    * @param record The record
+    * @param buffer The buffer to format into
+    * @param size The size of the buffer
+    */
+void format_trace_record(const trace_record_t *record, char *buffer, size_t size) {
+    switch (record->type) {
+        case TRACE_READY:
+            snprintf(buffer, size, "%d,READY,process_name=%s,assigned_at=%d", record->time,
+            record->process_name, record->value);
+            break;
+        case TRACE_RUNNING:
+            if (record->extra > 0) {
+                snprintf(buffer, size, "%d,RUNNING,process_name=%s,remaining_time=%d,quantum=%d", record->time,
+                record->process_name, record->value, record->extra);
+            } else {
+                snprintf(buffer, size, "%d,RUNNING,process_name=%s,remaining_time=%d", record->time,
+                record->process_name, record->value);
+            }
+            break;
+        case TRACE_FINISHED:
+            snprintf(buffer, size, "%d,FINISHED,process_name=%s,proc_remaining=%d", record->time,
+            record->process_name, record->value);
+            break;
+        case TRACE_FINISHED_PROCESS:
+            snprintf(buffer, size, "%d,FINISHED-PROCESS,process_name=%s", record->time, record->process_name);
+            break;
+        case TRACE_TURNAROUND:
+            snprintf(buffer, size, "Turnaround time %d", record->value);
+            break;
+        case TRACE_OVERHEAD:
+            snprintf(buffer, size, "Time overhead %.2f %.2f", record->value / 100.0, record->extra / 100.0);
+            break;
+        case TRACE_MAKESPAN:
+            snprintf(buffer, size, "Makespan %d", record->value);
+            break;
+        default:
+            snprintf(buffer, size, "<unknown record type %d>", record->type);
+            break;
+    }
+}
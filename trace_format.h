@@ -0,0 +1,58 @@
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "procsim.h"
+
+#define TRACE_MAGIC "PSTR"
+#define TRACE_MAGIC_LENGTH 4
+#define TRACE_VERSION 1
+#define TRACE_BUFFER_SIZE (1 << 20)
+
+// Types of trace records, the statistics lines are records too
+typedef enum {
+    TRACE_READY,
+    TRACE_RUNNING,
+    TRACE_FINISHED,
+    TRACE_FINISHED_PROCESS,
+    TRACE_TURNAROUND,
+    TRACE_OVERHEAD,
+    TRACE_MAKESPAN
+} TraceType;
+
+// One event or statistic of a trace, shared by the text and binary formats
+typedef struct {
+    uint8_t type;
+    int32_t time;
+    // READY: assigned_at, RUNNING: remaining_time, FINISHED: proc_remaining,
+    // statistics: the value, with time overheads in hundredths
+    int32_t value;
+    // RUNNING: quantum or 0, TRACE_OVERHEAD: average time overhead in hundredths
+    int32_t extra;
+    char process_name[PROCSIM_MAX_NAME_LENGTH + 1];
+} trace_record_t;
+
+// Streaming reader of a text or binary trace
+typedef struct {
+    FILE *file;
+    bool binary;
+    char *line;
+    size_t line_capacity;
+    // Line of the last text record, or index of the last binary record
+    unsigned long position;
+} trace_reader_t;
+
+// Trace format functions
+bool write_trace_header(FILE *file);
+bool write_trace_record(FILE *file, const trace_record_t *record);
+bool open_trace(trace_reader_t *reader, const char *filename);
+bool read_trace_record(trace_reader_t *reader, trace_record_t *record);
+void close_trace(trace_reader_t *reader);
+bool parse_trace_line(const char *line, trace_record_t *record);
+void format_trace_record(const trace_record_t *record, char *buffer, size_t size);
+
+#endif // TRACE_FORMAT_H
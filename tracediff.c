@@ -0,0 +1,468 @@
+#include "tracediff.h"
+
+/*
+    * Read the command line arguments.
+    *
+    * @param argc The number of command line arguments
+    * @param argv The array of command line arguments
+    * @param quiet Whether to leave out the per-job deltas
+    * @param tolerance The allowed regression of each metric in percent, negative to fail on any difference
+    * @param baseline_file The path to the baseline trace
+    * @param candidate_file The path to the candidate trace
+    */
+void read_arguments(int argc, char *argv[], bool *quiet, double *tolerance, char **baseline_file, char **candidate_file) {
+    int opt;
+
+    // Parse command line arguments
+    while ((opt = getopt(argc, argv, "qt:")) != -1) {
+        switch (opt) {
+            case 'q':
+                *quiet = true;
+                break;
+            case 't':
+                *tolerance = atof(optarg);
+                // Check if tolerance is valid
+                if (*tolerance < 0) {
+                    fprintf(stderr, "Invalid tolerance\n");
+                    exit(2);
+                }
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-q] [-t <percent>] <baseline> <candidate>\n", argv[0]);
+                exit(2);
+        }
+    }
+    // Check if both traces are provided
+    if (argc - optind != 2) {
+        fprintf(stderr, "Usage: %s [-q] [-t <percent>] <baseline> <candidate>\n", argv[0]);
+        exit(2);
+    }
+    *baseline_file = argv[optind];
+    *candidate_file = argv[optind + 1];
+}
+
+/*
+    * Hash a process name with FNV-1a.
+    *
+    * @param process_name The process name
+    * @return The hash of the name
+    */
+static size_t hash_name(const char *process_name) {
+    uint32_t hash = 2166136261u;
+
+    while (*process_name) {
+        hash ^= (unsigned char) *process_name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/*
+    * Initialise an empty table of pending jobs.
+    *
+    * @param table The table
+    */
+void init_pending_table(pending_table_t *table) {
+    table->bucket_count = INITIAL_BUCKET_COUNT;
+    table->buckets = (pending_job_t **) calloc(table->bucket_count, sizeof(pending_job_t *));
+    table->count = 0;
+}
+
+/*
+    * Free a table of pending jobs.
+    *
+    * @param table The table
+    */
+void free_pending_table(pending_table_t *table) {
+    for (size_t i = 0; i < table->bucket_count; i++) {
+        pending_job_t *job = table->buckets[i];
+        while (job) {
+            pending_job_t *next = job->next;
+            free(job);
+            job = next;
+        }
+    }
+    free(table->buckets);
+    table->buckets = NULL;
+    table->count = 0;
+}
+
+/*
+    * Remove the job the other trace left pending under the same name.
+    *
+    * @param table The table
+    * @param process_name The process name
+    * @param side The trace looking for its match
+    * @param finish_time The finish time recorded by the other trace
+    * @return True if the job was pending, false otherwise
+    */
+bool take_pending_job(pending_table_t *table, const char *process_name, TraceSide side, int32_t *finish_time) {
+    pending_job_t **link = &table->buckets[hash_name(process_name) & (table->bucket_count - 1)];
+
+    for (; *link; link = &(*link)->next) {
+        pending_job_t *job = *link;
+        if (job->side != side && strcmp(job->process_name, process_name) == 0) {
+            *finish_time = job->finish_time;
+            *link = job->next;
+            free(job);
+            table->count--;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+    * Double the number of buckets once the table gets crowded.
+    *
+    * @param table The table
+    */
+static void grow_pending_table(pending_table_t *table) {
+    size_t bucket_count = table->bucket_count * 2;
+    pending_job_t **buckets = (pending_job_t **) calloc(bucket_count, sizeof(pending_job_t *));
+
+    for (size_t i = 0; i < table->bucket_count; i++) {
+        pending_job_t *job = table->buckets[i];
+        while (job) {
+            pending_job_t *next = job->next;
+            size_t index = hash_name(job->process_name) & (bucket_count - 1);
+            job->next = buckets[index];
+            buckets[index] = job;
+            job = next;
+        }
+    }
+    free(table->buckets);
+    table->buckets = buckets;
+    table->bucket_count = bucket_count;
+}
+
+/*
+    * Remember a job until the other trace finishes it.
+    *
+    * @param table The table
+    * @param process_name The process name
+    * @param side The trace that finished the job
+    * @param finish_time The finish time
+    */
+void add_pending_job(pending_table_t *table, const char *process_name, TraceSide side, int32_t finish_time) {
+    pending_job_t *job = (pending_job_t *) malloc(sizeof(pending_job_t));
+    size_t index;
+
+    if (table->count >= table->bucket_count * 2) {
+        grow_pending_table(table);
+    }
+    index = hash_name(process_name) & (table->bucket_count - 1);
+    strcpy(job->process_name, process_name);
+    job->finish_time = finish_time;
+    job->side = side;
+    job->next = table->buckets[index];
+    table->buckets[index] = job;
+    table->count++;
+}
+
+/*
+    * Record the turnaround delta of a job found in both traces.
+    * Both runs share the arrival times, so the difference of the finish times is the turnaround delta.
+    *
+    * @param summary The delta summary
+    * @param process_name The process name
+    * @param baseline_time The finish time in the baseline
+    * @param candidate_time The finish time in the candidate
+    * @param quiet Whether to leave out the per-job line
+    */
+void record_delta(delta_summary_t *summary, const char *process_name, int32_t baseline_time, int32_t candidate_time, bool quiet) {
+    int32_t delta = candidate_time - baseline_time;
+
+    summary->matched++;
+    if (delta == 0) {
+        return;
+    }
+    summary->changed++;
+    summary->total_delta += delta;
+    if (delta > summary->worst_delta) {
+        summary->worst_delta = delta;
+        strcpy(summary->worst_job, process_name);
+    }
+    if (delta < summary->best_delta) {
+        summary->best_delta = delta;
+        strcpy(summary->best_job, process_name);
+    }
+    if (!quiet) {
+        printf("%s turnaround %+d (finished %d -> %d)\n", process_name, delta, baseline_time, candidate_time);
+    }
+}
+
+/*
+    * Add a record to the metrics of its trace and match finished jobs against the other trace.
+    *
+    * @param record The record
+    * @param side The trace the record belongs to
+    * @param metrics The metrics of that trace
+    * @param table The jobs waiting for their match
+    * @param summary The delta summary
+    * @param quiet Whether to leave out the per-job lines
+    */
+void process_record(const trace_record_t *record, TraceSide side, trace_metrics_t *metrics, pending_table_t *table, delta_summary_t *summary, bool quiet) {
+    int32_t other_time;
+
+    metrics->events++;
+    switch (record->type) {
+        case TRACE_RUNNING:
+            metrics->running_events++;
+            break;
+        case TRACE_FINISHED:
+            metrics->finished_jobs++;
+            metrics->total_finish_time += record->time;
+            if (!take_pending_job(table, record->process_name, side, &other_time)) {
+                add_pending_job(table, record->process_name, side, record->time);
+            } else if (side == BASELINE) {
+                record_delta(summary, record->process_name, record->time, other_time, quiet);
+            } else {
+                record_delta(summary, record->process_name, other_time, record->time, quiet);
+            }
+            break;
+        case TRACE_TURNAROUND:
+            metrics->has_statistics = true;
+            metrics->turnaround_time = record->value;
+            break;
+        case TRACE_OVERHEAD:
+            metrics->max_time_overhead = record->value;
+            metrics->average_time_overhead = record->extra;
+            break;
+        case TRACE_MAKESPAN:
+            metrics->makespan = record->value;
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+    * Check if two records describe the same event.
+    *
+    * @param first The first record
+    * @param second The second record
+    * @return True if the records are equal, false otherwise
+    */
+static bool same_record(const trace_record_t *first, const trace_record_t *second) {
+    return first->type == second->type && first->time == second->time && first->value == second->value
+    && first->extra == second->extra && strcmp(first->process_name, second->process_name) == 0;
+}
+
+/*
+    * Get the simulation time a record is ordered by when merging the traces.
+    *
+    * @param record The record
+    * @return The time of an event, or the end of time for the statistics
+    */
+static int32_t record_time(const trace_record_t *record) {
+    if (record->type >= TRACE_TURNAROUND) {
+        return INT32_MAX;
+    }
+    return record->time;
+}
+
+/*
+    * Print the first pair of records that differ.
+    *
+    * @param baseline The baseline record, NULL at the end of the baseline
+    * @param baseline_reader The baseline reader
+    * @param candidate The candidate record, NULL at the end of the candidate
+    * @param candidate_reader The candidate reader
+    * @param index The index of the records
+    */
+void print_divergence(const trace_record_t *baseline, const trace_reader_t *baseline_reader, const trace_record_t *candidate, const trace_reader_t *candidate_reader, unsigned long index) {
+    char line[LINE_BUFFER_SIZE];
+
+    printf("First divergence at record %lu (baseline %s %lu, candidate %s %lu)\n", index,
+    baseline_reader->binary ? "record" : "line", baseline_reader->position,
+    candidate_reader->binary ? "record" : "line", candidate_reader->position);
+    if (baseline) {
+        format_trace_record(baseline, line, sizeof(line));
+        printf("< %s\n", line);
+    } else {
+        printf("< <end of trace>\n");
+    }
+    if (candidate) {
+        format_trace_record(candidate, line, sizeof(line));
+        printf("> %s\n", line);
+    } else {
+        printf("> <end of trace>\n");
+    }
+}
+
+/*
+    * Print the jobs that only one of the traces finished.
+    *
+    * @param table The jobs left without a match
+    */
+static void print_unmatched_jobs(const pending_table_t *table) {
+    for (size_t i = 0; i < table->bucket_count; i++) {
+        for (pending_job_t *job = table->buckets[i]; job; job = job->next) {
+            printf("%s only finished in the %s (at %d)\n", job->process_name,
+            job->side == BASELINE ? "baseline" : "candidate", job->finish_time);
+        }
+    }
+}
+
+/*
+    * Print one row of the metric table.
+    *
+    * @param metric The name of the metric
+    * @param baseline The baseline value
+    * @param candidate The candidate value
+    */
+static void print_metric(const char *metric, double baseline, double candidate) {
+    printf("%-22s %14.2f %14.2f %+14.2f\n", metric, baseline, candidate, candidate - baseline);
+}
+
+/*
+    * Print the delta summary and the aggregate metrics of both traces.
+    *
+    * @param baseline The baseline metrics
+    * @param candidate The candidate metrics
+    * @param summary The delta summary
+    * @param table The jobs left without a match
+    */
+void print_summary(const trace_metrics_t *baseline, const trace_metrics_t *candidate, const delta_summary_t *summary, const pending_table_t *table) {
+    print_unmatched_jobs(table);
+
+    printf("Jobs matched %lu changed %lu unmatched %zu\n", summary->matched, summary->changed, table->count);
+    if (summary->matched > 0) {
+        printf("Turnaround delta total %+lld mean %+.2f\n", summary->total_delta,
+        (double) summary->total_delta / summary->matched);
+    }
+    if (summary->worst_delta > 0) {
+        printf("Largest regression %s %+d\n", summary->worst_job, summary->worst_delta);
+    }
+    if (summary->best_delta < 0) {
+        printf("Largest improvement %s %+d\n", summary->best_job, summary->best_delta);
+    }
+
+    // Print the aggregate metrics
+    printf("%-22s %14s %14s %14s\n", "Metric", "Baseline", "Candidate", "Delta");
+    print_metric("Events", baseline->events, candidate->events);
+    print_metric("Running events", baseline->running_events, candidate->running_events);
+    print_metric("Finished jobs", baseline->finished_jobs, candidate->finished_jobs);
+    if (baseline->has_statistics && candidate->has_statistics) {
+        print_metric("Turnaround time", baseline->turnaround_time, candidate->turnaround_time);
+        print_metric("Max time overhead", baseline->max_time_overhead / 100.0, candidate->max_time_overhead / 100.0);
+        print_metric("Average time overhead", baseline->average_time_overhead / 100.0,
+        candidate->average_time_overhead / 100.0);
+        print_metric("Makespan", baseline->makespan, candidate->makespan);
+    } else {
+        printf("Statistics missing from the %s\n", baseline->has_statistics ? "candidate" : "baseline");
+    }
+}
+
+/*
+    * Check if a metric where lower is better regressed beyond the tolerance.
+    *
+    * @param metric The name of the metric
+    * @param baseline The baseline value
+    * @param candidate The candidate value
+    * @param tolerance The allowed regression in percent
+    * @return True if the metric regressed, false otherwise
+    */
+bool check_regression(const char *metric, double baseline, double candidate, double tolerance) {
+    if (candidate <= baseline * (1 + tolerance / 100)) {
+        return false;
+    }
+    printf("Regression: %s %.2f -> %.2f exceeds %.2f%% tolerance\n", metric, baseline, candidate, tolerance);
+    return true;
+}
+
+/*
+    * The main function.
+    *
+    * @param argc The number of command line arguments
+    * @param argv The array of command line arguments
+    * @return 0 if the traces match (or stay within the tolerance), 1 if they differ (or regress), 2 on error
+*/
+int main(int argc, char *argv[]) {
+    bool quiet = false;
+    double tolerance = -1;
+    char *baseline_file = NULL;
+    char *candidate_file = NULL;
+    trace_reader_t baseline_reader, candidate_reader;
+    trace_record_t baseline_record, candidate_record;
+    trace_metrics_t baseline_metrics = {0}, candidate_metrics = {0};
+    delta_summary_t summary = {0};
+    pending_table_t table;
+    bool has_baseline, has_candidate;
+    bool diverged = false;
+    bool regressed = false;
+    unsigned long index = 0;
+
+    // Read the command line arguments
+    read_arguments(argc, argv, &quiet, &tolerance, &baseline_file, &candidate_file);
+
+    if (!open_trace(&baseline_reader, baseline_file)) {
+        fprintf(stderr, "Error opening trace: %s\n", baseline_file);
+        exit(2);
+    }
+    if (!open_trace(&candidate_reader, candidate_file)) {
+        fprintf(stderr, "Error opening trace: %s\n", candidate_file);
+        exit(2);
+    }
+    init_pending_table(&table);
+
+    // Walk both traces in lockstep until the first divergence
+    has_baseline = read_trace_record(&baseline_reader, &baseline_record);
+    has_candidate = read_trace_record(&candidate_reader, &candidate_record);
+    while (has_baseline && has_candidate && same_record(&baseline_record, &candidate_record)) {
+        index++;
+        process_record(&baseline_record, BASELINE, &baseline_metrics, &table, &summary, quiet);
+        process_record(&candidate_record, CANDIDATE, &candidate_metrics, &table, &summary, quiet);
+        has_baseline = read_trace_record(&baseline_reader, &baseline_record);
+        has_candidate = read_trace_record(&candidate_reader, &candidate_record);
+    }
+    if (has_baseline || has_candidate) {
+        print_divergence(has_baseline ? &baseline_record : NULL, &baseline_reader,
+        has_candidate ? &candidate_record : NULL, &candidate_reader, index + 1);
+        diverged = true;
+    }
+
+    // Then merge them by simulation time, so only jobs whose finish times drift apart are held in memory
+    while (has_baseline || has_candidate) {
+        if (has_baseline && (!has_candidate || record_time(&baseline_record) <= record_time(&candidate_record))) {
+            process_record(&baseline_record, BASELINE, &baseline_metrics, &table, &summary, quiet);
+            has_baseline = read_trace_record(&baseline_reader, &baseline_record);
+        } else {
+            process_record(&candidate_record, CANDIDATE, &candidate_metrics, &table, &summary, quiet);
+            has_candidate = read_trace_record(&candidate_reader, &candidate_record);
+        }
+    }
+
+    if (!diverged) {
+        printf("Traces match (%lu records)\n", index);
+    } else {
+        print_summary(&baseline_metrics, &candidate_metrics, &summary, &table);
+    }
+
+    // Check the metrics against the tolerance
+    if (tolerance >= 0 && diverged) {
+        if (!baseline_metrics.has_statistics || !candidate_metrics.has_statistics || table.count > 0) {
+            printf("Regression: the traces do not cover the same jobs\n");
+            regressed = true;
+        } else {
+            regressed |= check_regression("Turnaround time", baseline_metrics.turnaround_time,
+            candidate_metrics.turnaround_time, tolerance);
+            regressed |= check_regression("Max time overhead", baseline_metrics.max_time_overhead / 100.0,
+            candidate_metrics.max_time_overhead / 100.0, tolerance);
+            regressed |= check_regression("Average time overhead", baseline_metrics.average_time_overhead / 100.0,
+            candidate_metrics.average_time_overhead / 100.0, tolerance);
+            regressed |= check_regression("Makespan", baseline_metrics.makespan, candidate_metrics.makespan, tolerance);
+        }
+    }
+
+    // Free the memory
+    free_pending_table(&table);
+    close_trace(&baseline_reader);
+    close_trace(&candidate_reader);
+
+    if (tolerance >= 0) {
+        return regressed ? 1 : 0;
+    }
+    return diverged ? 1 : 0;
+}
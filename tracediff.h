@@ -0,0 +1,72 @@
+#ifndef TRACEDIFF_H
+#define TRACEDIFF_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <getopt.h>
+#include "trace_format.h"
+
+#define INITIAL_BUCKET_COUNT 64
+#define LINE_BUFFER_SIZE 256
+
+// Trace a record belongs to
+typedef enum {
+    BASELINE,
+    CANDIDATE
+} TraceSide;
+
+// Finish time of a job seen in only one of the traces so far
+typedef struct pending_job {
+    char process_name[PROCSIM_MAX_NAME_LENGTH + 1];
+    int32_t finish_time;
+    TraceSide side;
+    struct pending_job *next;
+} pending_job_t;
+
+// Jobs waiting for their match, bounded by how far the two schedules drift apart
+typedef struct {
+    pending_job_t **buckets;
+    size_t bucket_count;
+    size_t count;
+} pending_table_t;
+
+// Aggregate metrics of one trace
+typedef struct {
+    unsigned long events;
+    unsigned long running_events;
+    unsigned long finished_jobs;
+    long long total_finish_time;
+    bool has_statistics;
+    int32_t turnaround_time;
+    int32_t max_time_overhead;
+    int32_t average_time_overhead;
+    int32_t makespan;
+} trace_metrics_t;
+
+// Per-job turnaround deltas of the jobs found in both traces
+typedef struct {
+    unsigned long matched;
+    unsigned long changed;
+    long long total_delta;
+    int32_t worst_delta;
+    char worst_job[PROCSIM_MAX_NAME_LENGTH + 1];
+    int32_t best_delta;
+    char best_job[PROCSIM_MAX_NAME_LENGTH + 1];
+} delta_summary_t;
+
+// Trace diff functions
+void read_arguments(int argc, char *argv[], bool *quiet, double *tolerance, char **baseline_file, char **candidate_file);
+void init_pending_table(pending_table_t *table);
+void free_pending_table(pending_table_t *table);
+bool take_pending_job(pending_table_t *table, const char *process_name, TraceSide side, int32_t *finish_time);
+void add_pending_job(pending_table_t *table, const char *process_name, TraceSide side, int32_t finish_time);
+void record_delta(delta_summary_t *summary, const char *process_name, int32_t baseline_time, int32_t candidate_time, bool quiet);
+void process_record(const trace_record_t *record, TraceSide side, trace_metrics_t *metrics, pending_table_t *table, delta_summary_t *summary, bool quiet);
+void print_divergence(const trace_record_t *baseline, const trace_reader_t *baseline_reader, const trace_record_t *candidate, const trace_reader_t *candidate_reader, unsigned long index);
+void print_summary(const trace_metrics_t *baseline, const trace_metrics_t *candidate, const delta_summary_t *summary, const pending_table_t *table);
+bool check_regression(const char *metric, double baseline, double candidate, double tolerance);
+
+#endif // TRACEDIFF_H